@@ -0,0 +1,27 @@
+﻿#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+
+/* Счетчик выделений динамической памяти во всех потоках для отладочной сборки: в ней глобальные operator new
+   всех видов заменяются считающими. Позволяет проверить, что проходы отрисовки не выделяют память на каждую отрисовку.
+   В выпускной сборке operator new не заменяется и счетчик всегда равен нулю */
+class AllocationCounter {
+public:
+#ifdef _DEBUG
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+public:
+    AllocationCounter() = delete;
+
+    static size_t GetCount();
+    static void AddAllocation();
+
+private:
+    static std::atomic<size_t> cnt_allocations;
+};
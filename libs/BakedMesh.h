@@ -0,0 +1,118 @@
+﻿#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include "MappedFile.h"
+#include "Model.h"
+
+
+//C compatible POD structure
+struct BakedMeshHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t vertex_packing;
+    uint8_t cnt_attributes;
+    uint32_t vertex_stride;
+    uint32_t index_type;
+    uint32_t cnt_lods;
+    uint32_t reserved;
+    uint64_t cnt_vertexes;
+    uint64_t cnt_indexes;
+    uint64_t attributes_offset;
+    uint64_t lods_offset;
+    uint64_t vertexes_offset;
+    uint64_t positions_offset;
+    uint64_t indexes_offset;
+    uint64_t file_size;
+    float bounds_min[3];
+    float bounds_max[3];
+};
+
+//C compatible POD structure
+struct BakedVertexAttribute {
+    uint32_t location;
+    int32_t size;
+    uint32_t type;
+    uint32_t normalized;
+    uint64_t offset;
+};
+
+//C compatible POD structure
+struct BakedMeshLod {
+    uint32_t first_index;
+    uint32_t cnt_indexes;
+    float error;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(BakedMeshHeader) == 112 && sizeof(BakedVertexAttribute) == 24 && sizeof(BakedMeshLod) == 16);
+
+
+/* Запеченный меш: заголовок, описание формата вершин, таблица LOD и выровненные блоки вершин, позиций и индексов
+   ровно в том виде, в котором они лежат в буферах GeometryArena. Файл little-endian, отображается в память
+   и отдается в glBufferSubData без какого-либо преобразования по вершинам */
+class BakedMesh {
+public:
+    static constexpr uint32_t MAGIC = 0x48534D42; // "BMSH"
+    static constexpr uint16_t VERSION = 3; // 2: цепочка LOD с ошибкой упрощения, 3: касательная vec4 со знаком базиса
+    static constexpr uint64_t BLOB_ALIGNMENT = 256;
+    static constexpr std::string_view CACHE_DIRECTORY = "./cache/meshes";
+    static constexpr std::string_view EXTENSION = ".bmsh";
+
+public:
+    BakedMesh(const BakedMesh&) = delete;
+    BakedMesh& operator=(const BakedMesh&) = delete;
+
+    static std::shared_ptr<const BakedMesh> LoadBakedMesh(const std::filesystem::path&);
+    static std::shared_ptr<const BakedMesh> LoadCachedMesh(const std::filesystem::path&);
+    static bool SaveBakedMesh(const std::filesystem::path&, const MeshData&,
+                              const std::vector<MeshLodData>& = {}, VertexPacking = VertexPacking::AUTO);
+
+    VertexPacking GetVertexPacking() const;
+    GLenum GetIndexType() const;
+    size_t GetVertexCount() const;
+    size_t GetIndexCount() const;
+    const void* GetVertexData() const;
+    const void* GetPositionData() const;
+    const void* GetIndexData() const;
+    const std::vector<MeshLod>& GetLods() const;
+    glm::vec3 GetBoundsMin() const;
+    glm::vec3 GetBoundsMax() const;
+    size_t GetSize() const;
+
+private:
+    BakedMesh(MappedFile, const BakedMeshHeader&, std::vector<MeshLod>);
+
+    static bool IsCurrentVersion(const std::filesystem::path&);
+    static bool ValidateHeader(const BakedMeshHeader&, size_t);
+    static bool ValidateVertexFormat(const BakedMeshHeader&, const char*);
+    static bool ValidateIndexes(const BakedMeshHeader&, const char*);
+    static bool IsBlobInside(uint64_t, uint64_t, uint64_t, uint64_t, size_t);
+    static uint64_t AlignOffset(uint64_t, uint64_t);
+    static std::filesystem::path GetCachePath(const std::filesystem::path&);
+
+private:
+    static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+    static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+    MappedFile mapped_file;
+    BakedMeshHeader header;
+    std::vector<MeshLod> lods;
+};
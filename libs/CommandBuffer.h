@@ -0,0 +1,123 @@
+﻿#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+
+class Mesh;
+class ShaderPipe;
+class StreamBuffer;
+enum class VertexStream : uint8_t;
+
+
+enum class RenderCommandType : uint8_t {
+    USE_PROGRAM,
+    BIND_TEXTURE,
+    CULL_FACE,
+    USE_VERTEX_STREAM,
+    SET_INT,
+    SET_FLOAT,
+    SET_VEC3,
+    SET_MAT4,
+    DRAW_MESH
+};
+
+//C compatible POD structure
+struct RenderCommand {
+    RenderCommandType type;
+    uint32_t args[5];
+};
+
+
+/* Поток команд отрисовки, не зависящий от графического API; исполняется в потоке OpenGL */
+class CommandBuffer {
+public:
+    CommandBuffer() = default;
+
+    void Clear();
+    void UseProgram(uint32_t);
+    void BindTexture(GLuint, GLenum, GLuint);
+    void CullFace(GLenum);
+    void UseVertexStream(VertexStream);
+    void SetInt(GLint, GLint);
+    void SetFloat(GLint, GLfloat);
+    void SetVec3(GLint, const glm::vec3&);
+    void SetMat4(GLint, const glm::mat4&);
+    void DrawMesh(uint32_t, uint32_t, uint32_t = 0);
+    void AddInstance(const glm::mat4&);
+
+    void Execute(const std::vector<ShaderPipe>&, std::vector<Mesh>&, StreamBuffer&) const;
+    size_t GetCommandCount() const;
+
+private:
+    void Push(RenderCommandType, uint32_t = 0, uint32_t = 0, uint32_t = 0, uint32_t = 0, uint32_t = 0);
+    uint32_t PushData(const GLfloat*, size_t);
+
+private:
+    std::vector<RenderCommand> commands;
+    std::vector<GLfloat> data;
+};
+
+
+/* Параллельная запись команд прохода рабочими потоками по непрерывным диапазонам элементов */
+class CommandRecorder {
+public:
+    // Невладеющая ссылка на функцию записи: в отличие от std::function не выделяет память под захват лямбды
+    class RecordFunction {
+    public:
+        template <typename Function>
+        RecordFunction(const Function& function)
+            : function(&function), invoke([](const void *function, size_t begin, size_t end, CommandBuffer& command_buffer) {
+                  (*static_cast<const Function*>(function))(begin, end, command_buffer);
+              }) {}
+
+        void operator()(size_t begin, size_t end, CommandBuffer& command_buffer) const {
+            invoke(function, begin, end, command_buffer);
+        }
+
+    private:
+        const void *function;
+        void (*invoke)(const void*, size_t, size_t, CommandBuffer&);
+    };
+
+    static constexpr size_t MIN_ITEMS_PER_CHUNK = 256;
+
+public:
+    explicit CommandRecorder(size_t = std::thread::hardware_concurrency());
+    ~CommandRecorder();
+    CommandRecorder(const CommandRecorder&) = delete;
+    CommandRecorder& operator=(const CommandRecorder&) = delete;
+
+    void Record(size_t, const RecordFunction&);
+    void Execute(const std::vector<ShaderPipe>&, std::vector<Mesh>&, StreamBuffer&) const;
+
+private:
+    void WorkerLoop();
+    void RecordChunks();
+
+private:
+    std::vector<std::thread> workers;
+    std::vector<CommandBuffer> buffers;
+
+    std::mutex mutex;
+    std::condition_variable start_condition;
+    std::condition_variable done_condition;
+    uint64_t generation = 0;
+    size_t cnt_busy = 0;
+    bool stopping = false;
+
+    const RecordFunction *record = nullptr;
+    size_t cnt_items = 0;
+    size_t cnt_chunks = 0;
+    std::atomic<size_t> next_chunk{ 0 };
+    std::atomic<size_t> cnt_done{ 0 };
+};
@@ -0,0 +1,119 @@
+﻿#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <utility>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+
+enum class GLResourceType : uint8_t {
+    BUFFER,
+    TEXTURE,
+    VERTEX_ARRAY,
+    PROGRAM,
+    FRAMEBUFFER,
+    SAMPLER,
+    QUERY,
+    COUNT
+};
+
+struct GLResourceStats {
+    size_t live = 0;
+    size_t created = 0;
+    GLsizeiptr bytes = 0;
+};
+
+
+/* Учет живых GL-объектов по типам: количество и оценка занимаемой видеопамяти */
+class GLResourceRegistry {
+public:
+    GLResourceRegistry() = delete;
+
+    static GLuint Generate(GLResourceType);
+    static void Track(GLResourceType);
+    static void Delete(GLResourceType, GLuint, GLsizeiptr);
+    static void Resize(GLResourceType, GLsizeiptr, GLsizeiptr);
+    static void ReleaseContext();
+    static bool IsContextAlive();
+
+    static const GLResourceStats& GetStats(GLResourceType);
+    static void PrintStats();
+
+private:
+    static std::string_view GetTypeName(GLResourceType);
+
+private:
+    static std::array<GLResourceStats, static_cast<size_t>(GLResourceType::COUNT)> stats;
+    static bool context_alive;
+};
+
+
+/* Владеющий перемещаемый дескриптор GL-объекта, удаляет объект при разрушении */
+template <GLResourceType Type>
+class GLHandle {
+public:
+    GLHandle() = default;
+    explicit GLHandle(GLuint id) : id(id) {
+        if (id) {
+            GLResourceRegistry::Track(Type);
+        }
+    }
+    GLHandle(const GLHandle&) = delete;
+    GLHandle& operator=(const GLHandle&) = delete;
+    GLHandle(GLHandle&& other) noexcept
+        : id(std::exchange(other.id, 0)), size(std::exchange(other.size, 0)) {}
+    GLHandle& operator=(GLHandle&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            id = std::exchange(other.id, 0);
+            size = std::exchange(other.size, 0);
+        }
+        return *this;
+    }
+    ~GLHandle() {
+        Reset();
+    }
+
+    static GLHandle Create() {
+        GLHandle handle;
+        handle.id = GLResourceRegistry::Generate(Type);
+        return handle;
+    }
+
+    GLuint Get() const {
+        return id;
+    }
+
+    explicit operator bool() const {
+        return id != 0;
+    }
+
+    void SetSize(GLsizeiptr new_size) {
+        GLResourceRegistry::Resize(Type, size, new_size);
+        size = new_size;
+    }
+
+    void Reset() {
+        if (id) {
+            GLResourceRegistry::Delete(Type, id, size);
+        }
+        id = 0;
+        size = 0;
+    }
+
+private:
+    GLuint id = 0;
+    GLsizeiptr size = 0;
+};
+
+using GLBuffer = GLHandle<GLResourceType::BUFFER>;
+using GLTexture = GLHandle<GLResourceType::TEXTURE>;
+using GLVertexArray = GLHandle<GLResourceType::VERTEX_ARRAY>;
+using GLProgram = GLHandle<GLResourceType::PROGRAM>;
+using GLFramebuffer = GLHandle<GLResourceType::FRAMEBUFFER>;
+using GLSampler = GLHandle<GLResourceType::SAMPLER>;
+using GLQuery = GLHandle<GLResourceType::QUERY>;
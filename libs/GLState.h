@@ -0,0 +1,47 @@
+﻿#pragma once
+#include <array>
+#include <optional>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+
+struct GLStateStats {
+    size_t issued = 0;
+    size_t elided = 0;
+};
+
+
+/* Кэш состояния OpenGL, отбрасывающий повторную установку уже выставленных значений */
+class GLState {
+public:
+    static constexpr GLuint MAX_TEXTURE_UNITS = 32;
+
+public:
+    GLState() = delete;
+
+    static void UseProgram(GLuint);
+    static void BindVertexArray(GLuint);
+    static void ActiveTexture(GLuint);
+    static void BindTexture(GLuint, GLenum, GLuint);
+    static void CullFace(GLenum);
+    static void Invalidate();
+
+    static const GLStateStats& GetStats();
+    static void ResetStats();
+
+private:
+    template <typename Type>
+    static bool IsStateChanged(std::optional<Type>&, Type);
+    static std::optional<GLuint>* GetTextureBinding(GLuint, GLenum);
+
+private:
+    static std::optional<GLuint> program;
+    static std::optional<GLuint> vertex_array;
+    static std::optional<GLuint> active_texture;
+    static std::optional<GLenum> cull_face;
+    static std::array<std::optional<GLuint>, MAX_TEXTURE_UNITS> textures_2d;
+    static std::array<std::optional<GLuint>, MAX_TEXTURE_UNITS> textures_cube;
+
+    static GLStateStats stats;
+};
@@ -0,0 +1,131 @@
+﻿#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "GLResource.h"
+#include "GLState.h"
+
+
+struct VertexAttribute {
+    GLuint location;
+    GLint size;
+    GLenum type;
+    GLboolean normalized;
+    size_t offset;
+    GLuint divisor = 0;
+};
+
+enum class VertexStream : uint8_t {
+    FULL,
+    POSITION
+};
+
+struct VertexFormat {
+    GLsizei stride;
+    std::vector<VertexAttribute> attributes;
+};
+
+struct GeometryRange {
+    GLint base_vertex = 0;
+    GLuint first_index = 0;
+    GLsizei cnt_indexes = 0;
+    GLuint mesh_id = 0;
+};
+
+struct GeometryBlock {
+    GLsizeiptr first_vertex = 0;
+    GLsizeiptr cnt_vertexes = 0;
+    GLsizeiptr first_index = 0;
+    GLsizeiptr cnt_indexes = 0;
+};
+
+struct GeometryDrawStats {
+    size_t indexes = 0;
+};
+
+//C compatible POD structure
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instance_count;
+    GLuint first_index;
+    GLint base_vertex;
+    GLuint base_instance;
+};
+
+
+/* Общие вершинный и индексный буферы для статических мешей одного формата вершин и типа индексов с единственным VAO.
+   Индексы хранятся относительно начала меша, поэтому 16-битных хватает любому мешу до 65536 вершин.
+   Позиции дополнительно копируются в плотный поток со своим VAO для проходов, читающих только aPos.
+   Освобожденные диапазоны попадают в списки свободных блоков и переиспользуются, хвост арены сжимается сразу */
+class GeometryArena {
+public:
+    static constexpr GLsizeiptr INITIAL_VERTEX_CAPACITY = 1 << 16;
+    static constexpr GLsizeiptr INITIAL_INDEX_CAPACITY = 1 << 18;
+    static constexpr GLuint POSITION_LOCATION = 0;
+    static constexpr GLsizei POSITION_STRIDE = 3 * sizeof(GLfloat);
+
+public:
+    explicit GeometryArena(VertexFormat, GLenum = GL_UNSIGNED_INT);
+    GeometryArena(const GeometryArena&) = delete;
+    GeometryArena& operator=(const GeometryArena&) = delete;
+
+    GeometryRange Allocate(const void*, size_t, const std::vector<GLuint>&);
+    GeometryRange Allocate(const void*, size_t, const void*, size_t, const void* = nullptr);
+    void Free(const GeometryRange&);
+    GLuint GetVertexArray(VertexStream = VertexStream::FULL) const;
+    GLenum GetIndexType() const;
+    void DrawRange(const GeometryRange&, GLsizei, VertexStream = VertexStream::FULL) const;
+    void QueueDraw(const GeometryRange&, GLsizei, GLuint);
+    void FlushDraws(VertexStream = VertexStream::FULL);
+    bool IsQueueEmpty() const;
+
+    static bool IsMultiDrawIndirectSupported();
+    static GLsizeiptr GetIndexSize(GLenum);
+    static const GeometryDrawStats& GetDrawStats();
+    static void ResetDrawStats();
+
+private:
+    void Reserve(GLsizeiptr, GLsizeiptr);
+    void SetVertexFormat() const;
+    std::optional<size_t> GetPositionOffset() const;
+    static GLBuffer ResizeBuffer(const GLBuffer&, GLsizeiptr, GLsizeiptr);
+    static std::optional<GLsizeiptr> TakeFreeBlock(std::map<GLsizeiptr, GLsizeiptr>&, GLsizeiptr);
+    static void ReturnFreeBlock(std::map<GLsizeiptr, GLsizeiptr>&, GLsizeiptr, GLsizeiptr, GLsizeiptr&);
+
+private:
+    VertexFormat vertex_format;
+    GLenum index_type;
+    GLsizeiptr index_size;
+
+    GLVertexArray vertex_array;
+    GLVertexArray position_vertex_array;
+    GLBuffer vertex_buffer;
+    GLBuffer position_buffer;
+    GLBuffer index_buffer;
+    GLBuffer indirect_buffer;
+
+    GLsizeiptr vertex_capacity = 0;
+    GLsizeiptr index_capacity = 0;
+    GLsizeiptr indirect_capacity = 0;
+    GLsizeiptr cnt_vertexes = 0;
+    GLsizeiptr cnt_indexes = 0;
+
+    static GLuint cnt_meshes;
+    static GeometryDrawStats draw_stats;
+
+    std::vector<DrawElementsIndirectCommand> queued_draws;
+    std::unordered_map<GLuint, GeometryBlock> blocks;
+    std::map<GLsizeiptr, GLsizeiptr> free_vertexes;
+    std::map<GLsizeiptr, GLsizeiptr> free_indexes;
+};
@@ -0,0 +1,57 @@
+﻿#pragma once
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+enum class JsonType : uint8_t {
+    NUL,
+    BOOLEAN,
+    NUMBER,
+    STRING,
+    ARRAY,
+    OBJECT
+};
+
+
+/* Минимальное дерево JSON для разбора заголовков glTF. Обращение к отсутствующему полю или элементу
+   возвращает общий null, поэтому цепочки обращений не требуют проверок на каждом шаге */
+class JsonValue {
+public:
+    JsonValue() = default;
+
+    static std::optional<JsonValue> Parse(std::string_view);
+
+    JsonType GetType() const;
+    bool IsNull() const;
+    bool Contains(std::string_view) const;
+    size_t GetSize() const;
+    double GetNumber(double = 0.0) const;
+    bool GetBoolean(bool = false) const;
+    const std::string& GetString() const;
+    const std::vector<JsonValue>& GetArray() const;
+
+    const JsonValue& operator[](std::string_view) const;
+    const JsonValue& operator[](size_t) const;
+
+private:
+    static bool ParseValue(std::string_view, size_t&, JsonValue&, size_t);
+    static bool ParseString(std::string_view, size_t&, std::string&);
+    static bool ParseNumber(std::string_view, size_t&, double&);
+    static void SkipWhitespace(std::string_view, size_t&);
+    static void AppendUtf8(std::string&, uint32_t);
+
+private:
+    static constexpr size_t MAX_DEPTH = 256;
+
+    JsonType type = JsonType::NUL;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+};
@@ -6,18 +6,25 @@ LightPoint::LightPoint(glm::vec3 position, glm::vec3 ambient, glm::vec3 diffuse,
     : position(position), ambient(ambient), diffuse(diffuse), specular(specular),
       attenuation_const(attenuation_const), attenuation_lin(attenuation_lin), attenuation_quad(attenuation_quad) {}
 
-void LightPoint::UseLight(const ShaderPipe &shader_program, int idx) const {
-    std::stringstream name;
-    name << LIGHT << "[" << idx << "]" << ".";
-    shader_program.SetVec3(name.str() + std::string(POSITION), position);
-
-    shader_program.SetVec3(name.str() + std::string(AMBIDENT), ambient);
-    shader_program.SetVec3(name.str() + std::string(DIFFUSE), diffuse);
-    shader_program.SetVec3(name.str() + std::string(SPECULAR), specular);
-
-    shader_program.SetFloat(name.str() + std::string(ATTENUATION_CONST), attenuation_const);
-    shader_program.SetFloat(name.str() + std::string(ATTENUATION_LIN), attenuation_lin);
-    shader_program.SetFloat(name.str() + std::string(ATTENUATION_QUAD), attenuation_quad);
+void LightPoint::UseLight(UniformBuffer &light_point_buffer, int idx) const {
+    if (idx < 0 || idx >= static_cast<int>(LightPointParamStd140::MAX_CNT_LIGHT_POINT)) {
+        std::cerr << "ERROR::LIGHT::LIGHT_POINT_INDEX_OUT_OF_RANGE" << std::endl;
+        return;
+    }
+
+    LightStd140 light{};
+    light.position = position;
+
+    light.ambient = ambient;
+    light.diffuse = diffuse;
+    light.specular = specular;
+
+    light.attenuation_const = attenuation_const;
+    light.attenuation_lin = attenuation_lin;
+    light.attenuation_quad = attenuation_quad;
+
+    light_point_buffer.UpdateUniformBuffer(offsetof(LightPointParamStd140, light_point) + idx * sizeof(LightStd140),
+                                           sizeof(LightStd140), &light);
 }
 
 glm::vec3 LightPoint::GetPosition() const {
@@ -28,16 +35,18 @@ glm::vec3 LightPoint::GetPosition() const {
 LightDirected::LightDirected(glm::vec3 position, glm::vec3 direction, glm::vec3 ambient, glm::vec3 diffuse, glm::vec3 specular)
     : position(position), direction(direction), ambient(ambient), diffuse(diffuse), specular(specular) {}
 
-void LightDirected::UseLight(const ShaderPipe& shader_program) const {
-    std::stringstream name;
-    name << LIGHT << ".";
-    shader_program.SetVec3(name.str() + std::string(POSITION), position);
+void LightDirected::UseLight(UniformBuffer& light_directed_buffer) const {
+    LightStd140 light{};
+    light.position = position;
+
+    light.direction = direction;
 
-    shader_program.SetVec3(name.str() + std::string(DIRECTION), direction);
+    light.ambient = ambient;
+    light.diffuse = diffuse;
+    light.specular = specular;
 
-    shader_program.SetVec3(name.str() + std::string(AMBIDENT), ambient);
-    shader_program.SetVec3(name.str() + std::string(DIFFUSE), diffuse);
-    shader_program.SetVec3(name.str() + std::string(SPECULAR), specular);
+    light_directed_buffer.UpdateUniformBuffer(offsetof(LightDirectedParamStd140, light_directed),
+                                              sizeof(LightStd140), &light);
 }
 
 glm::vec3 LightDirected::GetPosition() const {
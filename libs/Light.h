@@ -1,12 +1,13 @@
 #pragma once
-#include <sstream>
+#include <cstddef>
+#include <iostream>
 #include <string>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 
-#include "Shader.h"
+#include "UniformBuffer.h"
 
 
 class LightPoint {
@@ -15,18 +16,9 @@ public:
 
 public:
     LightPoint(glm::vec3, glm::vec3, glm::vec3, glm::vec3, GLfloat, GLfloat, GLfloat);
-    void UseLight(const ShaderPipe&, int) const;
+    void UseLight(UniformBuffer&, int) const;
     glm::vec3 GetPosition() const;
 
-private:
-    static constexpr std::string_view POSITION = "position";
-    static constexpr std::string_view AMBIDENT = "ambient";
-    static constexpr std::string_view DIFFUSE = "diffuse";
-    static constexpr std::string_view SPECULAR = "specular";
-    static constexpr std::string_view ATTENUATION_CONST = "attenuation_const";
-    static constexpr std::string_view ATTENUATION_LIN = "attenuation_lin";
-    static constexpr std::string_view ATTENUATION_QUAD = "attenuation_quad";
-
 private:
     glm::vec3 position;
 
@@ -46,17 +38,10 @@ public:
 
 public:
     LightDirected(glm::vec3, glm::vec3, glm::vec3, glm::vec3, glm::vec3);
-    void UseLight(const ShaderPipe&) const;
+    void UseLight(UniformBuffer&) const;
     glm::vec3 GetPosition() const;
     glm::vec3 GetDirection() const;
 
-private:
-    static constexpr std::string_view POSITION = "position";
-    static constexpr std::string_view DIRECTION = "direction";
-    static constexpr std::string_view AMBIDENT = "ambient";
-    static constexpr std::string_view DIFFUSE = "diffuse";
-    static constexpr std::string_view SPECULAR = "specular";
-
 private:
     glm::vec3 position;
     glm::vec3 direction;
@@ -0,0 +1,32 @@
+﻿#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <iostream>
+#include <string_view>
+#include <utility>
+
+
+/* Файл, отображенный в память только для чтения: CreateFileMapping на Windows, mmap на POSIX.
+   Дескрипторы файла закрываются сразу после отображения, объект владеет только видом на данные */
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::filesystem::path&);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) noexcept;
+    MappedFile& operator=(MappedFile&&) noexcept;
+
+    bool IsOpen() const;
+    const char* GetData() const;
+    size_t GetSize() const;
+    std::string_view GetView() const;
+
+private:
+    void Close();
+
+private:
+    const char *data = nullptr;
+    size_t size = 0;
+};
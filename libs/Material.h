@@ -0,0 +1,54 @@
+﻿#pragma once
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "Texture.h"
+#include "Shader.h"
+
+
+using MaterialHandle = uint32_t;
+
+
+/* Материал: набор текстур с параметрами и заранее вычисленной раскладкой по текстурным блокам.
+   Материалы живут в общем реестре, объекты ссылаются на них по дескриптору и удерживают ссылку через AcquireMaterial.
+   Когда последняя ссылка отпущена, текстуры материала освобождаются, а дескриптор переиспользуется */
+class Material {
+public:
+    explicit Material(std::vector<Texture2D>&&);
+
+    const std::vector<size_t>& BindShaderPipe(const ShaderPipe&);
+    void UseMaterial(const ShaderPipe&);
+    const std::vector<Texture2D>& GetTextures() const;
+
+    static MaterialHandle CreateMaterial(std::vector<Texture2D>&&);
+    static std::shared_ptr<Material> AcquireMaterial(MaterialHandle);
+    static Material& GetMaterial(MaterialHandle);
+
+private:
+    struct MaterialSlot;
+
+    static void ReleaseMaterial(MaterialHandle);
+    static std::deque<MaterialSlot>& GetMaterials();
+    static std::vector<MaterialHandle>& GetFreeHandles();
+
+private:
+    std::vector<Texture2D> textures;
+    std::vector<TextureUniformNames> texture_names;
+    std::vector<GLuint> texture_units;
+    std::unordered_map<GLuint, std::vector<size_t>> texture_bindings;
+};
+
+struct Material::MaterialSlot {
+    std::optional<Material> material;
+    size_t cnt_references = 0;
+};
@@ -0,0 +1,118 @@
+﻿#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include "JsonValue.h"
+#include "MappedFile.h"
+#include "MeshOptimizer.h"
+#include "Model.h"
+
+
+struct MeshImportStats {
+    size_t cnt_files = 0;
+    size_t bytes = 0;
+    std::chrono::duration<double, std::milli> time{ 0.0 };
+};
+
+
+/* Импорт мешей из OBJ и glTF 2.0 (.glb). Файл отображается в память и разбирается параллельно по фрагментам,
+   результат сразу собирается в MeshData со сваренными вершинами, нормалями и касательными */
+class MeshImporter {
+public:
+    static constexpr size_t MIN_CHUNK_SIZE = 1 << 20;
+    static constexpr uint32_t GLB_MAGIC = 0x46546C67; // "glTF"
+    static constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A; // "JSON"
+    static constexpr uint32_t GLB_CHUNK_BIN = 0x004E4942; // "BIN"
+
+public:
+    MeshImporter() = delete;
+
+    static std::optional<MeshData> LoadMesh(const std::filesystem::path&);
+    static std::optional<MeshData> LoadObj(std::string_view);
+    static std::optional<MeshData> LoadGlb(std::string_view);
+    static void ComputeNormals(MeshData&);
+    static void ComputeTangents(MeshData&);
+
+    static const MeshImportStats& GetStats();
+    static void PrintStats();
+
+private:
+    static constexpr int64_t NO_INDEX = std::numeric_limits<int64_t>::min();
+
+    //C compatible POD structure
+    struct ObjCorner {
+        int64_t position;
+        int64_t texture_position;
+        int64_t normal;
+        uint8_t relative;
+    };
+
+    struct ObjCornerHash {
+        size_t operator()(const ObjCorner&) const;
+    };
+
+    struct ObjCornerEqual {
+        bool operator()(const ObjCorner&, const ObjCorner&) const;
+    };
+
+    struct ObjChunk {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> texture_positions;
+        std::vector<glm::vec3> normals;
+        std::vector<ObjCorner> corners;
+        bool valid = true;
+    };
+
+    struct GltfAccessor {
+        const char *data = nullptr;
+        size_t count = 0;
+        size_t stride = 0;
+        size_t components = 0;
+        GLenum component_type = GL_FLOAT;
+        bool normalized = false;
+    };
+
+    struct GltfInstance {
+        size_t mesh;
+        glm::mat4 world;
+    };
+
+    static void ParseObjChunk(std::string_view, ObjChunk&);
+    static bool BuildObjChunk(const ObjChunk&, const std::vector<glm::vec3>&, const std::vector<glm::vec2>&,
+                              const std::vector<glm::vec3>&, const std::array<size_t, 3>&, MeshData&);
+
+    static std::vector<GltfInstance> GetGltfInstances(const JsonValue&);
+    static glm::mat4 GetGltfNodeMatrix(const JsonValue&);
+    static std::optional<GltfAccessor> GetGltfAccessor(const JsonValue&, const JsonValue&, std::string_view);
+    static size_t GetGltfSize(const JsonValue&, size_t = 0);
+    static GLfloat ReadGltfComponent(const GltfAccessor&, size_t, size_t);
+    static GLuint ReadGltfIndex(const GltfAccessor&, size_t);
+    static bool BuildGltfPrimitive(const JsonValue&, const JsonValue&, const glm::mat4&, std::string_view, MeshData&);
+
+    static void ParallelFor(size_t, const std::function<void(size_t)>&);
+    static MeshData MergeMeshData(std::vector<MeshData>&);
+
+private:
+    static MeshImportStats stats;
+};
@@ -0,0 +1,39 @@
+﻿#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include "Model.h"
+
+
+struct VertexCacheStats {
+    GLfloat acmr = 0.0f;
+    GLfloat atvr = 0.0f;
+};
+
+
+/* Оптимизация индексированного меша при импорте: порядок треугольников под кэш вершин после преобразования (Tipsify),
+   сортировка кластеров треугольников против перерисовки и перенумерация вершин в порядке первого обращения */
+class MeshOptimizer {
+public:
+    static constexpr size_t VERTEX_CACHE_SIZE = 16;
+    static constexpr GLfloat OVERDRAW_THRESHOLD = 1.05f;
+
+public:
+    MeshOptimizer() = delete;
+
+    static void OptimizeMesh(MeshData&);
+    static std::vector<GLuint> OptimizeVertexCache(const std::vector<GLuint>&, size_t, std::vector<size_t>&);
+    static void OptimizeOverdraw(std::vector<GLuint>&, const std::vector<Vertex>&, const std::vector<size_t>&);
+    static void OptimizeVertexFetch(MeshData&);
+    static VertexCacheStats AnalyzeVertexCache(const std::vector<GLuint>&, size_t);
+
+private:
+    static bool TouchVertex(GLuint, std::vector<size_t>&, size_t&);
+};
@@ -0,0 +1,70 @@
+﻿#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include "MeshOptimizer.h"
+#include "Model.h"
+
+
+/* Построение цепочки LOD по квадрикам ошибки (Garland-Heckbert). Ребра сжимаются в уже существующую вершину,
+   поэтому все LOD ссылаются на общий буфер вершин меша. Вершины на швах атрибутов и неманифолдные вершины закреплены,
+   граничные сдвигаются только вдоль границы */
+class MeshSimplifier {
+public:
+    static constexpr size_t MAX_LODS = 8;
+    static constexpr size_t MIN_LOD_TRIANGLES = 32;
+    static constexpr GLfloat LOD_REDUCTION = 0.5f;
+    static constexpr GLfloat MIN_LOD_REDUCTION = 0.85f;
+    static constexpr GLfloat MAX_LOD_ERROR = 0.05f; // Доля радиуса ограничивающей сферы меша
+
+public:
+    MeshSimplifier() = delete;
+
+    static std::vector<MeshLodData> GenerateLods(const MeshData&);
+    static std::vector<GLuint> Simplify(const std::vector<Vertex>&, const std::vector<GLuint>&, size_t, GLfloat, GLfloat&);
+
+private:
+    enum class VertexKind : uint8_t {
+        MANIFOLD,
+        BORDER,
+        LOCKED
+    };
+
+    //C compatible POD structure
+    struct Quadric {
+        double a00, a01, a02, a11, a12, a22;
+        double b0, b1, b2;
+        double c;
+        double weight;
+    };
+
+    struct Collapse {
+        GLuint from;
+        GLuint to;
+        double error;
+    };
+
+    static constexpr size_t MAX_PASSES = 64;
+    static constexpr double BORDER_WEIGHT = 10.0;
+    static constexpr GLfloat FLIP_THRESHOLD = 0.25f;
+
+    static std::vector<GLuint> GetPositionRemap(const std::vector<Vertex>&);
+    static std::unordered_map<uint64_t, GLuint> CountEdges(const std::vector<GLuint>&, const std::vector<GLuint>&);
+    static uint64_t GetEdgeKey(GLuint, GLuint);
+    static void AddPlane(Quadric&, const glm::vec3&, GLfloat, double);
+    static void AddQuadric(Quadric&, const Quadric&);
+    static double EvaluateQuadric(const Quadric&, const glm::vec3&);
+    static bool HasFlip(const std::vector<Vertex>&, const std::vector<GLuint>&, const std::vector<GLuint>&,
+                        const std::vector<size_t>&, const std::vector<size_t>&, GLuint, GLuint, const glm::vec3&);
+};
@@ -1,15 +1,24 @@
 #pragma once
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <unordered_map>
 #include <vector>
 #include <string>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "./GeometryArena.h"
+#include "./Material.h"
 #include "./Texture.h"
 #include "./Shader.h"
 
@@ -19,33 +28,123 @@ struct Vertex {
     glm::vec3 position;
     glm::vec3 normal;
     glm::vec2 texture_position;
-    glm::vec3 tangent;
-    glm::vec3 bitangent;
+    glm::vec4 tangent; // w - handedness of the basis, bitangent = cross(normal, tangent) * w
+};
+
+//C compatible POD structure
+struct PackedVertex {
+    glm::vec3 position;
+    GLuint normal;
+    GLuint tangent;
+    GLuint texture_position;
+};
+
+
+struct MeshLod {
+    GLuint first_index = 0;
+    GLsizei cnt_indexes = 0;
+    GLfloat error = 0.0f;
+};
+
+
+struct MeshLodData {
+    std::vector<GLuint> indexes;
+    GLfloat error = 0.0f;
+};
+
+
+struct MeshData {
+    std::vector<Vertex> vertexes;
+    std::vector<GLuint> indexes;
 };
 
 
+enum class VertexPacking : uint8_t {
+    AUTO,
+    FLOAT,
+    PACKED
+};
+
+enum class MeshResidency : uint8_t {
+    RETAIN,
+    DISCARD,
+    POSITIONS
+};
+
+struct MeshMemoryStats {
+    size_t gpu_bytes = 0;
+    size_t cpu_bytes = 0;
+    size_t released_bytes = 0;
+    size_t packing_saved_bytes = 0;
+};
+
+
+class BakedMesh;
+
+
 class Mesh {
 public:
     static constexpr std::string_view MATERIAL = "material";
+    static constexpr GLfloat MAX_TEXTURE_COORD_ERROR = 1.0f / 4096.0f;
 
 public:
-    Mesh(const std::vector<Vertex>&, 
-         const std::vector<GLuint>&,
-         const std::vector<Texture2D>&, 
+    Mesh(std::vector<Vertex>, 
+         std::vector<GLuint>,
+         MaterialHandle, 
          bool = true);
-    void InitializeMesh();
-    void DrawMesh(const ShaderPipe &);
+    Mesh(MeshData, MaterialHandle, bool = true);
+    Mesh(std::shared_ptr<const BakedMesh>, MaterialHandle, bool = true);
+    void InitializeMesh(MeshResidency = MeshResidency::RETAIN, VertexPacking = VertexPacking::AUTO);
+    const std::vector<size_t>& BindShaderPipe(const ShaderPipe &) const;
+    void BindMaterial(const ShaderPipe &) const;
+    void DrawMesh(GLuint, GLintptr, GLsizei, VertexStream = VertexStream::FULL, size_t = 0) const;
+    void QueueMesh(GLsizei, GLuint, size_t = 0) const;
+    MaterialHandle GetMaterial() const;
+    bool HasSameMaterial(const Mesh &) const;
     bool IsVolume() const;
+    MeshResidency GetResidency() const;
+    VertexPacking GetVertexPacking() const;
+    const std::vector<MeshLod>& GetLods() const;
+    GeometryRange GetLodRange(size_t) const;
+    glm::vec4 GetBoundingSphere() const;
+    GeometryArena& GetArena() const;
+    size_t GetResidentBytes() const;
+
+    static GeometryArena& GetGeometryArena(VertexPacking, GLenum);
+    static VertexFormat GetVertexFormat(VertexPacking);
+    static glm::vec3 NormalizeDirection(const glm::vec3&);
+    static VertexPacking ChooseVertexPacking(const std::vector<Vertex>&);
+    static std::vector<PackedVertex> PackVertexes(const std::vector<Vertex>&);
+    static const MeshMemoryStats& GetMemoryStats();
+    static void PrintMemoryStats();
 
 public:
     std::vector<Vertex> vertexes;
     std::vector<GLuint> indexes;
-    std::vector<Texture2D> textures;
+    std::vector<glm::vec3> positions;
+    std::shared_ptr<const BakedMesh> baked_mesh;
+    std::vector<MeshLod> lods;
+    glm::vec4 bounding_sphere{ 0.0f };
+    MaterialHandle material;
+    std::shared_ptr<Material> material_reference;
     bool volume;
 
-    GLuint VAO = 0, VBO = 0, IBO = 0;
+    GeometryRange geometry;
+    std::shared_ptr<const GeometryRange> geometry_reference;
+    GLenum index_type = GL_UNSIGNED_INT;
+    VertexPacking vertex_packing = VertexPacking::FLOAT;
+    MeshResidency residency = MeshResidency::RETAIN;
+
+private:
+    void InitializeBakedMesh(MeshResidency);
+    void RetainGeometry(size_t);
+
+private:
+    static MeshMemoryStats memory_stats;
 };
 
+static_assert(sizeof(Vertex) == 48 && sizeof(PackedVertex) == 24);
+
 template <typename Type>
 static size_t SizeofContainer(const std::vector<Type>&);
 
@@ -53,19 +152,13 @@ static size_t SizeofContainer(const std::vector<Type>&);
 
 class FigurePosition {
 public:
-    static constexpr std::string_view FIGURE_POSITION = "figure_position";
-    static constexpr std::string_view MODEL = "model";
-    static constexpr std::string_view VIEW = "view";
-    static constexpr std::string_view PROJECTION = "projection";
+    static constexpr GLuint MODEL_LOCATION = 5;
+    static constexpr GLuint MODEL_COLUMNS = 4;
 
 public:
-    FigurePosition(glm::mat4, glm::mat4, glm::mat4);
-    void UseFigurePosition(const ShaderPipe&) const;
+    FigurePosition() = delete;
 
-private:
-    glm::mat4 model;
-    glm::mat4 view;
-    glm::mat4 projection;
+    static void BindInstanceAttribute(GLuint, GLintptr);
 };
 
 
@@ -0,0 +1,65 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+
+struct DrawItem {
+    uint64_t key;
+    size_t object;
+};
+
+struct DenseIndex {
+    GLuint index;
+    uint64_t pass;
+};
+
+
+/* Очередь отрисовки одного прохода, упорядоченная по 64-битным ключам */
+class RenderQueue {
+public:
+    // Разрядность полей ключа, от старших битов к младшим
+    static constexpr uint32_t PASS_BITS = 4;
+    static constexpr uint32_t PROGRAM_BITS = 12;
+    static constexpr uint32_t MATERIAL_BITS = 16;
+    static constexpr uint32_t MESH_BITS = 12;
+    static constexpr uint32_t LOD_BITS = 3;
+    static constexpr uint32_t DEPTH_BITS = 17;
+
+public:
+    RenderQueue() = default;
+
+    uint64_t MakeSortKey(uint32_t, GLuint, GLuint, GLuint, uint32_t, GLfloat, GLfloat);
+
+    void Clear();
+    void Push(uint64_t, size_t);
+    void Sort();
+    const std::vector<DrawItem>& GetItems() const;
+
+private:
+    static uint64_t PackField(uint64_t, uint32_t, uint32_t);
+    GLuint GetDenseIndex(std::unordered_map<GLuint, DenseIndex>&, GLuint, uint32_t);
+
+private:
+    static constexpr uint32_t RADIX_BITS = 8;
+    static constexpr size_t RADIX_SIZE = size_t(1) << RADIX_BITS;
+
+    std::vector<DrawItem> items;
+    std::vector<DrawItem> sorted_items;
+
+    // Идентификаторы программ, материалов и мешей сквозные и со временем не помещаются в поля ключа,
+    // поэтому в ключ идут их плотные номера. Номер хранит проход, в котором он использовался последним
+    std::unordered_map<GLuint, DenseIndex> program_indexes;
+    std::unordered_map<GLuint, DenseIndex> material_indexes;
+    std::unordered_map<GLuint, DenseIndex> mesh_indexes;
+    uint64_t cnt_passes = 0;
+    bool overflow_reported = false;
+};
+
+static_assert(RenderQueue::PASS_BITS + RenderQueue::PROGRAM_BITS + RenderQueue::MATERIAL_BITS +
+              RenderQueue::MESH_BITS + RenderQueue::LOD_BITS + RenderQueue::DEPTH_BITS == 64);
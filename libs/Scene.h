@@ -1,5 +1,12 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <glad/glad.h>
@@ -8,17 +15,36 @@
 
 #include "Model.h"
 #include "Camera.h"
+#include "CommandBuffer.h"
+#include "GLState.h"
+#include "StreamBuffer.h"
 #include "Light.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "RenderQueue.h"
 #include "Texture.h"
 #include "Shader.h"
+#include "UniformBuffer.h"
 
 
-/*   Vertex      */
+/*   Vertex     ,       ,
+             */
 class ObjectCreater {
 public:
     ObjectCreater(const std::vector<glm::vec3>&, const std::vector<glm::vec3>&, const std::vector<glm::vec2>&, 
                   const std::vector<GLuint>&, const std::vector<GLuint>&, const std::vector<GLuint>&, size_t);
-    std::vector<Vertex> CreateObject() const;
+    MeshData CreateObject() const;
+
+    static MeshData WeldVertexes(const std::vector<Vertex>&);
+
+private:
+    struct VertexHash {
+        size_t operator()(const Vertex&) const;
+    };
+
+    struct VertexEqual {
+        bool operator()(const Vertex&, const Vertex&) const;
+    };
 
 private:
     static std::pair<glm::vec3, glm::vec3> GetBiTangent(const std::vector<glm::vec3>&, const glm::vec3, const std::vector<glm::vec2>&);
@@ -50,119 +76,172 @@ public:
 		LightDirected& light_directed, std::vector<Transform>& transforms)
 		: objects(objects), shadow_texture(shadow_texture), shadow_FBO(shadow_FBO),
 		  shadow_cube(shadow_cube), shadow_cube_FBO(shadow_cube_FBO), lights_point(lights_point), 
-		  light_directed(light_directed), transforms(transforms) {}
+		  light_directed(light_directed), transforms(transforms) {
+		camera_param.CreateUniformBuffer(sizeof(CameraParamStd140), UniformBuffer::CAMERA_PARAM_BINDING);
+		light_directed_param.CreateUniformBuffer(sizeof(LightDirectedParamStd140), UniformBuffer::LIGHT_DIRECTED_PARAM_BINDING);
+		light_point_param.CreateUniformBuffer(sizeof(LightPointParamStd140), UniformBuffer::LIGHT_POINT_PARAM_BINDING);
+		stream_buffer.CreateStreamBuffer();
+	}
 
-    void Rendering(GLfloat scr_wight, GLfloat scr_height, std::vector<ShaderPipe>& shader_programs, GLfloat time, SwitchRender switch_render) {
-		static std::vector<std::vector<glm::mat4>> shadow_transforms(lights_point.size());
+	void BeginFrame() {
+		stream_buffer.BeginFrame();
+	}
+
+	void EndFrame() {
+		stream_buffer.EndFrame();
+	}
 
+    void Rendering(GLfloat scr_wight, GLfloat scr_height, std::vector<ShaderPipe>& shader_programs, GLfloat time, SwitchRender switch_render) {
 		switch (switch_render) {
 		case SwitchRender::SHADOW_MAP: {
 			GLfloat near_plane = 1.0f, far_plane = 7.5f;
-			glm::mat4 light_projection = glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, near_plane, far_plane);
+			GLfloat shadow_extent = 10.0f;
+			glm::mat4 light_projection = glm::ortho(-shadow_extent, shadow_extent, -shadow_extent, shadow_extent, near_plane, far_plane);
 			glm::mat4 light_view = glm::lookAt(light_directed.GetPosition(), light_directed.GetDirection(), glm::vec3(0.0f, 1.0f, 0.0f));
 			light_space = light_projection * light_view;
+			camera_param.UpdateUniformBuffer(offsetof(CameraParamStd140, light_space), sizeof(glm::mat4), &light_space);
+			camera_param.CommitUniformBuffer(stream_buffer);
 
-			shader_programs[0].UseShaderPipe();
-			shader_programs[0].SetMat4("light_space", light_space);
-			glActiveTexture(GL_TEXTURE0);
-
-			for (size_t idx = 0; idx < objects.size(); ++idx) {
-				if (objects[idx].IsVolume()) {
-					glCullFace(GL_FRONT);
-				}
-				model = glm::mat4(1.0f);
-				model = glm::translate(model, transforms[idx].translate);
-				model = glm::rotate(model, glm::radians(transforms[idx].turn), glm::vec3(1.0f));
-				model = glm::scale(model, transforms[idx].scale);
+			GLState::ActiveTexture(0);
 
-				FigurePosition figure_position{ model, view, projection };
-				figure_position.UseFigurePosition(shader_programs[0]);
+			const std::vector<uint8_t> &lods = SelectLods(SHADOW_MAP_LODS,
+				LodView{ light_directed.GetPosition(), 0.5f * scr_height / shadow_extent, true, LOD_PIXEL_ERROR * SHADOW_LOD_BIAS });
 
-				objects[idx].DrawMesh(shader_programs[0]);
-				glCullFace(GL_BACK);
+			shadow_queue.Clear();
+			for (size_t idx = 0; idx < objects.size(); ++idx) {
+				shadow_queue.Push(MakeDrawKey(shadow_queue, switch_render, shader_programs[0], idx, lods[idx], light_directed.GetPosition(), far_plane), idx);
 			}
+			shadow_queue.Sort();
+
+			command_recorder.Record(shadow_queue.GetItems().size(), [&](size_t begin, size_t end, CommandBuffer &command_buffer) {
+				command_buffer.UseProgram(0);
+				command_buffer.UseVertexStream(VertexStream::POSITION);
+				const auto &items = shadow_queue.GetItems();
+				for (size_t item = begin; item < end; ++item) {
+					size_t idx = items[item].object;
+					if (item == begin || !IsSameDraw(items[item - 1].object, idx, shader_programs, true, lods)) {
+						command_buffer.CullFace(objects[idx].IsVolume() ? GL_FRONT : GL_BACK);
+						command_buffer.DrawMesh(idx, 0, lods[idx]);
+					}
+					command_buffer.AddInstance(GetModelMatrix(idx));
+				}
+			});
+			command_recorder.Execute(shader_programs, objects, stream_buffer);
+			GLState::CullFace(GL_BACK);
 			break;
 		} 
 		case SwitchRender::SHADOW_CUBE: {
 			GLfloat coef_resolution = static_cast<GLfloat>(scr_wight) / scr_height;
 			GLfloat near_plane = 1.0f, far_plane = 25.0f;
 			glm::mat4 shadow_projection = glm::perspective(glm::radians(90.0f), coef_resolution, near_plane, far_plane);
-			for (size_t idx = 0; idx < lights_point.size(); ++idx) {
-				shadow_transforms[idx].clear();
-				shadow_transforms[idx].emplace_back(shadow_projection * glm::lookAt(lights_point[idx].GetPosition(),
-					lights_point[idx].GetPosition() + glm::vec3(1.0f, 0.0f, 0.0f),
-					glm::vec3(0.0f, -1.0f, 0.0f)));
-				shadow_transforms[idx].emplace_back(shadow_projection * glm::lookAt(lights_point[idx].GetPosition(),
-					lights_point[idx].GetPosition() + glm::vec3(-1.0f, 0.0f, 0.0f),
-					glm::vec3(0.0f, -1.0f, 0.0f)));
-				shadow_transforms[idx].emplace_back(shadow_projection * glm::lookAt(lights_point[idx].GetPosition(),
-					lights_point[idx].GetPosition() + glm::vec3(0.0f, 1.0f, 0.0f),
-					glm::vec3(0.0f, 0.0f, 1.0f)));
-				shadow_transforms[idx].emplace_back(shadow_projection * glm::lookAt(lights_point[idx].GetPosition(),
-					lights_point[idx].GetPosition() + glm::vec3(0.0f, -1.0f, 0.0f),
-					glm::vec3(0.0f, 0.0f, -1.0f)));
-				shadow_transforms[idx].emplace_back(shadow_projection * glm::lookAt(lights_point[idx].GetPosition(),
-					lights_point[idx].GetPosition() + glm::vec3(0.0f, 0.0f, 1.0f),
-					glm::vec3(0.0f, -1.0f, 0.0f)));
-				shadow_transforms[idx].emplace_back(shadow_projection * glm::lookAt(lights_point[idx].GetPosition(),
-					lights_point[idx].GetPosition() + glm::vec3(0.0f, 0.0f, -1.0f),
-					glm::vec3(0.0f, -1.0f, 0.0f)));
+			for (size_t idx = 0; idx < lights_point.size() && idx < shadow_cube.size(); ++idx) {
+				glm::vec3 light_position = lights_point[idx].GetPosition();
+				std::array<glm::mat4, CNT_CUBE_FACES> shadow_transforms = {
+					shadow_projection * glm::lookAt(light_position, light_position + glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)),
+					shadow_projection * glm::lookAt(light_position, light_position + glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)),
+					shadow_projection * glm::lookAt(light_position, light_position + glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)),
+					shadow_projection * glm::lookAt(light_position, light_position + glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f)),
+					shadow_projection * glm::lookAt(light_position, light_position + glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, -1.0f, 0.0f)),
+					shadow_projection * glm::lookAt(light_position, light_position + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, -1.0f, 0.0f))
+				};
 				shader_programs[0].UseShaderPipe();
-				for (size_t jdx = 0; jdx < shadow_transforms[idx].size(); ++jdx) {
-					std::stringstream name;
-					name << "shadow_view[" << jdx << "]";
-					shader_programs[0].SetMat4(name.str(), shadow_transforms[idx][jdx]);
-				}
-				shader_programs[0].SetFloat("far_plane", far_plane);
-				shader_programs[0].SetVec3("light_position", lights_point[idx].GetPosition());
-				//shadow_cube[idx].UseTextureForShadowRendering();
-				for (size_t jdx = 0; jdx < objects.size(); ++jdx) {
-					model = glm::mat4(1.0f);
-					model = glm::translate(model, transforms[jdx].translate);
-					model = glm::rotate(model, glm::radians(transforms[jdx].turn), glm::vec3(1.0f));
-					model = glm::scale(model, transforms[jdx].scale);
-
-					FigurePosition figure_position{ model, view, projection };
-					figure_position.UseFigurePosition(shader_programs[0]);
-
-					objects[jdx].DrawMesh(shader_programs[0]);
+				shader_programs[0].SetFloat(shader_programs[0].GetLocation(far_plane_name), far_plane);
+				shader_programs[0].SetVec3(shader_programs[0].GetLocation(light_position_name), light_position);
+				//      90 , tan(45) = 1
+				const std::vector<uint8_t> &lods = SelectLods(SHADOW_CUBE_LODS + idx,
+					LodView{ light_position, 0.5f * scr_height, false, LOD_PIXEL_ERROR * SHADOW_LOD_BIAS });
+
+				//   ,    -       
+				//        ,     
+				for (size_t face = 0; face < shadow_transforms.size(); ++face) {
+					BindShadowCubeFace(shadow_cube[idx], shadow_cube_FBO, static_cast<GLuint>(face));
+					glClear(GL_DEPTH_BUFFER_BIT);
+					shader_programs[0].SetMat4(shader_programs[0].GetLocation(shadow_view_name), shadow_transforms[face]);
+
+					shadow_queue.Clear();
+					for (size_t jdx = 0; jdx < objects.size(); ++jdx) {
+						if (IsInsideCubeFace(jdx, light_position, face, far_plane)) {
+							shadow_queue.Push(MakeDrawKey(shadow_queue, switch_render, shader_programs[0], jdx, lods[jdx], light_position, far_plane), jdx);
+						}
+					}
+					shadow_queue.Sort();
+
+					command_recorder.Record(shadow_queue.GetItems().size(), [&](size_t begin, size_t end, CommandBuffer &command_buffer) {
+						command_buffer.UseProgram(0);
+						command_buffer.UseVertexStream(VertexStream::POSITION);
+						const auto &items = shadow_queue.GetItems();
+						for (size_t item = begin; item < end; ++item) {
+							size_t jdx = items[item].object;
+							if (item == begin || !IsSameDraw(items[item - 1].object, jdx, shader_programs, true, lods)) {
+								command_buffer.DrawMesh(jdx, 0, lods[jdx]);
+							}
+							command_buffer.AddInstance(GetModelMatrix(jdx));
+						}
+					});
+					command_recorder.Execute(shader_programs, objects, stream_buffer);
 				}
 			}
 			break;
 		}
 		case SwitchRender::SCENE: {
-			projection = glm::perspective(glm::radians(camera->GetZoom()), scr_wight / scr_height, 0.1f, 100.0f);
+			projection = glm::perspective(glm::radians(camera->GetZoom()), scr_wight / scr_height, 0.1f, SCENE_FAR_PLANE);
 			view = camera->GetViewMatrix();
 
-			for (size_t idx = 0; idx < objects.size(); ++idx) {
-				model = glm::mat4(1.0f);
-				model = glm::translate(model, transforms[idx].translate);
-				model = glm::rotate(model, glm::radians(transforms[idx].turn), glm::vec3(1.0f));
-				model = glm::scale(model, transforms[idx].scale);
-
-				shader_programs[idx].UseShaderPipe();
-				shader_programs[idx].SetMat4("light_space", light_space);
+			CameraParamStd140 camera_data{};
+			camera_data.view = view;
+			camera_data.projection = projection;
+			camera_data.light_space = light_space;
+			camera_data.view_position = camera->GetPosition();
+			camera_param.UpdateUniformBuffer(0, sizeof(CameraParamStd140), &camera_data);
+
+			GLfloat far_plane = 25.0f;
+			light_point_param.UpdateUniformBuffer(offsetof(LightPointParamStd140, far_plane), sizeof(GLfloat), &far_plane);
+			for (size_t jdx = 0; jdx < lights_point.size(); ++jdx) {
+				lights_point[jdx].UseLight(light_point_param, jdx);
+			}
 
-				shadow_texture.UseTexture(shader_programs[idx], std::string(Texture2D::SHADOW_MAP), SHADOW_MAP_POSITION);
-				shader_programs[idx].SetInt(std::string(Texture2D::SHADOW_MAP), SHADOW_MAP_POSITION);
+			light_directed.UseLight(light_directed_param);
 
-				for (size_t jdx = 0; jdx < shadow_cube.size(); ++jdx) {
-					shadow_cube[jdx].UseTexture(shader_programs[idx], std::string(TextureCube::SHADOW_CUBE_MAP), SHADOW_CUBE_MAP_POSITION + jdx);
-				}
+			camera_param.CommitUniformBuffer(stream_buffer);
+			light_point_param.CommitUniformBuffer(stream_buffer);
+			light_directed_param.CommitUniformBuffer(stream_buffer);
 
-				FigurePosition figure_position{ model, view, projection };
-				figure_position.UseFigurePosition(shader_programs[idx]);
-				shader_programs[idx].SetVec3("view_position", camera->GetPosition());
+			const std::vector<uint8_t> &lods = SelectLods(SCENE_LODS, LodView{ camera->GetPosition(),
+				0.5f * scr_height / std::tan(0.5f * glm::radians(camera->GetZoom())), false, LOD_PIXEL_ERROR });
 
-				for (size_t jdx = 0; jdx < lights_point.size(); ++jdx) {
-					lights_point[jdx].UseLight(shader_programs[idx], jdx);
-					shader_programs[idx].SetFloat("far_plane", 25.0f);
+			scene_queue.Clear();
+			for (size_t idx = 0; idx < objects.size(); ++idx) {
+				scene_queue.Push(MakeDrawKey(scene_queue, switch_render, shader_programs[idx], idx, lods[idx], camera->GetPosition(), SCENE_FAR_PLANE), idx);
+			}
+			scene_queue.Sort();
+
+			//        ,        
+			GLState::BindTexture(TextureUnits::SHADOW_MAP, GL_TEXTURE_2D, shadow_texture.GetTextureID().value_or(0));
+			for (size_t jdx = 0; jdx < shadow_cube.size(); ++jdx) {
+				auto unit = TextureUnits::GetTextureUnit(TextureCube::SHADOW_CUBE_MAP, static_cast<GLuint>(jdx));
+				if (unit) {
+					GLState::BindTexture(*unit, GL_TEXTURE_CUBE_MAP, shadow_cube[jdx].GetTextureID().value_or(0));
 				}
-
-				light_directed.UseLight(shader_programs[idx]);
-
-				objects[idx].DrawMesh(shader_programs[idx]);
 			}
+
+			command_recorder.Record(scene_queue.GetItems().size(), [&](size_t begin, size_t end, CommandBuffer &command_buffer) {
+				const auto &items = scene_queue.GetItems();
+				for (size_t item = begin; item < end; ++item) {
+					size_t idx = items[item].object;
+					if (item != begin && IsSameDraw(items[item - 1].object, idx, shader_programs, false, lods)) {
+						command_buffer.AddInstance(GetModelMatrix(idx));
+						continue;
+					}
+
+					if (item == begin || shader_programs[items[item - 1].object].GetShaderPipeID() != shader_programs[idx].GetShaderPipeID()) {
+						command_buffer.UseProgram(idx);
+					}
+
+					command_buffer.DrawMesh(idx, idx, lods[idx]);
+					command_buffer.AddInstance(GetModelMatrix(idx));
+				}
+			});
+			command_recorder.Execute(shader_programs, objects, stream_buffer);
 			break;
 		}
 		default:
@@ -184,8 +263,113 @@ public:
 	}
 
 private:
-	static constexpr GLuint SHADOW_MAP_POSITION = 5;
-	static constexpr GLuint SHADOW_CUBE_MAP_POSITION = 6;
+	struct LodView {
+		glm::vec3 eye;
+		GLfloat pixels_per_unit;
+		bool orthographic;
+		GLfloat max_pixel_error;
+	};
+
+private:
+	glm::mat4 GetModelMatrix(size_t idx) const {
+		glm::mat4 model = glm::mat4(1.0f);
+		model = glm::translate(model, transforms[idx].translate);
+		model = glm::rotate(model, glm::radians(transforms[idx].turn), glm::vec3(1.0f));
+		model = glm::scale(model, transforms[idx].scale);
+		return model;
+	}
+
+	//        , LOD,   
+	bool IsSameDraw(size_t lhs, size_t rhs, const std::vector<ShaderPipe> &shader_programs, bool shared_program,
+		const std::vector<uint8_t> &lods) const {
+		const Mesh &lhs_object = objects[lhs];
+		const Mesh &rhs_object = objects[rhs];
+		if (lhs_object.geometry.mesh_id != rhs_object.geometry.mesh_id || lods[lhs] != lods[rhs] ||
+			lhs_object.IsVolume() != rhs_object.IsVolume()) {
+			return false;
+		}
+		if (!shared_program && shader_programs[lhs].GetShaderPipeID() != shader_programs[rhs].GetShaderPipeID()) {
+			return false;
+		}
+		return lhs_object.HasSameMaterial(rhs_object);
+	}
+
+	uint64_t MakeDrawKey(RenderQueue &queue, SwitchRender pass, const ShaderPipe &shader_program, size_t idx, uint8_t lod,
+		glm::vec3 eye, GLfloat far_plane) const {
+		const Mesh &object = objects[idx];
+		return queue.MakeSortKey(static_cast<uint32_t>(pass), shader_program.GetShaderPipeID().value_or(0), object.GetMaterial(),
+			object.geometry.mesh_id, lod, glm::distance(eye, transforms[idx].translate), far_plane);
+	}
+
+	//      :      45 
+	//   ,      (forward - |side|) / sqrt(2)
+	bool IsInsideCubeFace(size_t idx, glm::vec3 light_position, size_t face, GLfloat far_plane) const {
+		glm::vec4 bounding_sphere = objects[idx].GetBoundingSphere();
+		glm::vec3 scale = glm::abs(transforms[idx].scale);
+		GLfloat radius = bounding_sphere.w * std::max(scale.x, std::max(scale.y, scale.z));
+		glm::vec3 offset = glm::vec3(GetModelMatrix(idx) * glm::vec4(glm::vec3(bounding_sphere), 1.0f)) - light_position;
+
+		size_t axis = face / 2;
+		GLfloat forward = face % 2 == 0 ? offset[axis] : -offset[axis];
+		GLfloat side_margin = radius * std::sqrt(2.0f);
+		return forward <= far_plane + radius &&
+			forward - std::abs(offset[(axis + 1) % 3]) >= -side_margin &&
+			forward - std::abs(offset[(axis + 2) % 3]) >= -side_margin;
+	}
+
+	// LOD       ,      
+	const std::vector<uint8_t>& SelectLods(size_t slot, const LodView &lod_view) {
+		if (selected_lods.size() <= slot) {
+			selected_lods.resize(slot + 1);
+		}
+		std::vector<uint8_t> &lods = selected_lods[slot];
+		lods.resize(objects.size(), 0);
+		for (size_t idx = 0; idx < objects.size(); ++idx) {
+			lods[idx] = SelectLod(idx, lod_view, lods[idx]);
+		}
+		return lods;
+	}
+
+	//    LOD,          .
+	//     LOD   LOD_HYSTERESIS,        
+	uint8_t SelectLod(size_t idx, const LodView &lod_view, uint8_t previous_lod) const {
+		const std::vector<MeshLod> &lods = objects[idx].GetLods();
+		if (lods.size() < 2) {
+			return 0;
+		}
+
+		glm::vec4 bounding_sphere = objects[idx].GetBoundingSphere();
+		glm::vec3 scale = glm::abs(transforms[idx].scale);
+		GLfloat max_scale = std::max(scale.x, std::max(scale.y, scale.z));
+		GLfloat pixels_per_error = lod_view.pixels_per_unit * max_scale;
+		if (!lod_view.orthographic) {
+			glm::vec3 center = glm::vec3(GetModelMatrix(idx) * glm::vec4(glm::vec3(bounding_sphere), 1.0f));
+			GLfloat distance = glm::distance(lod_view.eye, center) - bounding_sphere.w * max_scale;
+			pixels_per_error /= std::max(distance, MIN_LOD_DISTANCE);
+		}
+
+		size_t lod = std::min<size_t>(previous_lod, lods.size() - 1);
+		while (lod > 0 && lods[lod].error * pixels_per_error > lod_view.max_pixel_error) {
+			--lod;
+		}
+		while (lod + 1 < lods.size() && lods[lod + 1].error * pixels_per_error <= lod_view.max_pixel_error * LOD_HYSTERESIS) {
+			++lod;
+		}
+		return static_cast<uint8_t>(lod);
+	}
+
+private:
+	static constexpr GLfloat SCENE_FAR_PLANE = 100.0f;
+	static constexpr GLfloat LOD_PIXEL_ERROR = 1.0f;
+	static constexpr GLfloat SHADOW_LOD_BIAS = 4.0f;
+	static constexpr GLfloat LOD_HYSTERESIS = 0.75f;
+	static constexpr GLfloat MIN_LOD_DISTANCE = 0.1f;
+	static constexpr size_t SCENE_LODS = 0;
+	static constexpr size_t SHADOW_MAP_LODS = 1;
+	static constexpr size_t SHADOW_CUBE_LODS = 2;
+	static constexpr size_t CNT_CUBE_FACES = 6;
+
+	static_assert(MeshSimplifier::MAX_LODS <= (size_t(1) << RenderQueue::LOD_BITS));
 
 private:
     std::vector<Mesh>& objects;
@@ -199,9 +383,22 @@ private:
 
 	CameraFly *camera = nullptr;
 
+	UniformBuffer camera_param;
+	UniformBuffer light_directed_param;
+	UniformBuffer light_point_param;
+
+	RenderQueue shadow_queue;
+	RenderQueue scene_queue;
+	std::vector<std::vector<uint8_t>> selected_lods;
+	CommandRecorder command_recorder;
+	StreamBuffer stream_buffer;
+
+	UniformName shadow_view_name{ "shadow_view" };
+	UniformName far_plane_name{ "far_plane" };
+	UniformName light_position_name{ "light_position" };
+
 	glm::mat4 light_space{0.0f};
 
-	glm::mat4 model{0.0f};
 	glm::mat4 view{0.0f};
 	glm::mat4 projection{0.0f};
 };
@@ -1,10 +1,19 @@
 #pragma once
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <deque>
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <glad/glad.h>
@@ -13,6 +22,11 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "GLResource.h"
+#include "GLState.h"
+#include "ShaderCache.h"
+#include "UniformBuffer.h"
+
 
 class Shader {
 public:
@@ -20,18 +34,85 @@ public:
     void DeleteShader();
     std::optional<GLuint> GetShaderID() const;
     void LoadRealizationShader(const std::string &, int);
+    void CompileRealizationShader(const std::string &, int);
+    void SubmitRealizationShader(const std::string &);
+    bool CheckRealizationShader(int) const;
 private:
     std::optional<GLuint> shader_id;
     GLenum type_shader;
 };
 
 
+using UniformLocation = GLint;
+using ShaderDefines = std::map<std::string, std::string>;
+
+
+class UniformName {
+public:
+    explicit UniformName(std::string_view);
+    UniformName(std::string_view, size_t);
+    size_t GetHandle() const;
+    const std::string& GetName() const;
+
+private:
+    static std::unordered_map<std::string, size_t>& GetHandles();
+    static std::deque<std::string>& GetNames();
+
+private:
+    size_t handle;
+};
+
+template <size_t... Idx>
+std::array<UniformName, sizeof...(Idx)> MakeUniformNameArray(std::string_view name, std::index_sequence<Idx...>) {
+    return { UniformName(name, Idx)... };
+}
+
+template <size_t Size>
+std::array<UniformName, Size> MakeUniformNameArray(std::string_view name) {
+    return MakeUniformNameArray(name, std::make_index_sequence<Size>());
+}
+
+
+struct ShaderParameter {
+    std::string name;
+    GLenum type = 0;
+    UniformLocation location = -1;
+    bool sampler = false;
+};
+
+struct ShaderBlock {
+    std::string name;
+    GLuint index = 0;
+    GLint size = 0;
+    std::optional<GLuint> binding;
+};
+
+
+struct UniformUploadStats {
+    size_t uploaded = 0;
+    size_t skipped = 0;
+    size_t missing = 0;
+};
+
+
 class ShaderPipe {
 public:
     ShaderPipe();
     std::optional <GLuint> GetShaderPipeID() const;
     void CreateShaderPipe(const std::vector<Shader>&, int);
-    GLint GetLocation(const std::string&) const;
+    void LinkShaderPipe(const std::vector<Shader>&);
+    bool IsShaderPipeReady() const;
+    bool FinishShaderPipe(int);
+    bool CreateShaderPipeFromBinary(const ShaderCache::ProgramBinary&);
+    std::optional<ShaderCache::ProgramBinary> GetShaderPipeBinary() const;
+    UniformLocation GetLocation(const std::string&) const;
+    UniformLocation GetLocation(const UniformName&) const;
+    std::optional<size_t> GetSlot(const std::string&) const;
+    std::optional<size_t> GetSlot(const UniformName&) const;
+    bool HasParameter(const UniformName&) const;
+    const ShaderParameter& GetParameter(size_t) const;
+    const std::vector<ShaderParameter>& GetParameters() const;
+    const std::vector<ShaderBlock>& GetBlocks() const;
     void UseShaderPipe() const;
     void SetInt(const std::string&, GLint) const;
     void SetFloat(const std::string&, GLfloat) const;
@@ -41,17 +122,100 @@ public:
     void SetMat2(const std::string&, const glm::mat2&) const;
     void SetMat3(const std::string&, const glm::mat3&) const;
     void SetMat4(const std::string&, const glm::mat4&) const;
+    void SetInt(UniformLocation, GLint) const;
+    void SetFloat(UniformLocation, GLfloat) const;
+    void SetVec2(UniformLocation, const glm::vec2&) const;
+    void SetVec3(UniformLocation, const glm::vec3&) const;
+    void SetVec4(UniformLocation, const glm::vec4&) const;
+    void SetMat2(UniformLocation, const glm::mat2&) const;
+    void SetMat3(UniformLocation, const glm::mat3&) const;
+    void SetMat4(UniformLocation, const glm::mat4&) const;
+
+    static const UniformUploadStats& GetUploadStats();
+    static void ResetUploadStats();
+private:
+    struct UniformValue {
+        std::array<GLfloat, 16> data{};
+        size_t size = 0;
+    };
+
+    struct UniformState {
+        std::vector<ShaderParameter> parameters;
+        std::vector<ShaderBlock> blocks;
+        std::unordered_map<std::string, size_t> slots;
+        std::vector<std::optional<size_t>> handle_slots;
+        std::unordered_map<UniformLocation, UniformValue> values;
+    };
+
+private:
+    static constexpr size_t MISSING_SLOT = std::numeric_limits<size_t>::max();
+
+private:
+    void ReflectShaderPipe();
+    void ReflectUniformBlocks();
+    static bool IsSamplerType(GLenum);
+    bool IsUniformChanged(UniformLocation, const void*, size_t) const;
+
 private:
     std::optional<GLuint> shader_pipe_id = 0;
+    std::shared_ptr<GLProgram> program_handle;
+    std::shared_ptr<UniformState> uniform_state = std::make_shared<UniformState>();
+
+    static UniformUploadStats upload_stats;
 };
 
 
 struct ShaderLoadInfo {
-    ShaderLoadInfo(const std::string &, const GLenum);
+    ShaderLoadInfo(const std::string &, const GLenum, const ShaderDefines & = {});
 
     std::string file_shader_path;
     GLenum type_shader;
+    ShaderDefines defines;
+};
+
+
+std::optional<std::string> ReadRealizationShader(const std::string &);
+
+std::string InjectShaderDefines(const std::string &, const ShaderDefines &);
+
+
+class ShaderCompiler {
+public:
+    static constexpr double POLL_INTERVAL = 0.005;
+
+public:
+    ShaderCompiler();
+    ~ShaderCompiler();
+    ShaderCompiler(const ShaderCompiler&) = delete;
+    ShaderCompiler& operator=(const ShaderCompiler&) = delete;
+    ShaderPipe SubmitShaderProgram(std::vector<ShaderLoadInfo>::const_iterator, std::vector<ShaderLoadInfo>::const_iterator,
+                                   const ShaderDefines & = {});
+    bool IsReady() const;
+    bool Finish();
+
+private:
+    struct PendingProgram {
+        std::string variant_key;
+        ShaderPipe shader_program;
+        std::vector<Shader> shaders;
+        std::vector<std::pair<GLenum, std::string>> sources;
+        bool cache_supported = false;
+        bool cache_rejected = false;
+        uint64_t cache_key = 0;
+        std::chrono::steady_clock::time_point start_time;
+    };
+
+private:
+    static std::string GetVariantKey(std::vector<ShaderLoadInfo>::const_iterator, std::vector<ShaderLoadInfo>::const_iterator,
+                                     const ShaderDefines &);
+    static void EnableParallelCompile();
+
+private:
+    std::vector<PendingProgram> pending_programs;
+
+    static std::unordered_map<std::string, ShaderPipe> shader_variants;
 };
 
 
-ShaderPipe CreateShaderProgram(std::vector<ShaderLoadInfo>::const_iterator, std::vector<ShaderLoadInfo>::const_iterator);
+ShaderPipe CreateShaderProgram(std::vector<ShaderLoadInfo>::const_iterator, std::vector<ShaderLoadInfo>::const_iterator,
+                               const ShaderDefines & = {});
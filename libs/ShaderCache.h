@@ -0,0 +1,57 @@
+﻿#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+
+struct ShaderCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t rejected = 0;
+    std::chrono::duration<double, std::milli> hits_time{ 0.0 };
+    std::chrono::duration<double, std::milli> misses_time{ 0.0 };
+};
+
+
+/* Дисковый кэш бинарных образов шейдерных программ (glGetProgramBinary/glProgramBinary) */
+class ShaderCache {
+public:
+    using ProgramBinary = std::pair<GLenum, std::vector<GLchar>>;
+
+public:
+    static constexpr std::string_view CACHE_DIRECTORY = "./cache/shaders";
+
+public:
+    ShaderCache() = delete;
+
+    static bool IsSupported();
+    static uint64_t ComputeKey(const std::vector<std::pair<GLenum, std::string>>&);
+    static std::optional<ProgramBinary> LoadProgramBinary(uint64_t);
+    static void SaveProgramBinary(uint64_t, const ProgramBinary&);
+    static void RemoveProgramBinary(uint64_t);
+
+    static void AddHit(std::chrono::duration<double, std::milli>);
+    static void AddMiss(std::chrono::duration<double, std::milli>, bool);
+    static const ShaderCacheStats& GetStats();
+    static void PrintStats();
+
+private:
+    static std::filesystem::path GetCachePath(uint64_t);
+
+private:
+    static constexpr uint32_t CACHE_MAGIC = 0x42505347; // "GSPB"
+    static constexpr uint32_t CACHE_VERSION = 2;
+    static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+    static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+    static ShaderCacheStats stats;
+};
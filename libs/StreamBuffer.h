@@ -0,0 +1,54 @@
+﻿#pragma once
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "GLResource.h"
+
+
+/* Кольцевой буфер покадровых данных (матрицы экземпляров, uniform-блоки), разделенный на кадры в полете */
+class StreamBuffer {
+public:
+    static constexpr size_t FRAMES_IN_FLIGHT = 3;
+    static constexpr GLsizeiptr INITIAL_FRAME_SIZE = 4 * 1024 * 1024;
+    static constexpr GLuint64 FENCE_TIMEOUT = 1000000000;
+
+public:
+    StreamBuffer() = default;
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+    ~StreamBuffer();
+
+    void CreateStreamBuffer(GLsizeiptr = INITIAL_FRAME_SIZE);
+    std::optional<GLuint> GetStreamBufferID() const;
+    GLsizeiptr GetUniformAlignment() const;
+    bool IsPersistent() const;
+
+    void BeginFrame();
+    void EndFrame();
+    bool HasSpace(GLsizeiptr, GLsizeiptr) const;
+    GLintptr Write(const void*, GLsizeiptr, GLsizeiptr);
+
+private:
+    void AllocateStorage(GLsizeiptr);
+    void ReleaseStorage();
+    static GLintptr AlignOffset(GLintptr, GLsizeiptr);
+
+private:
+    GLBuffer stream_buffer;
+    std::vector<GLBuffer> retired_buffers;
+    GLubyte *mapped_data = nullptr;
+    bool persistent = false;
+
+    GLsizeiptr frame_size = 0;
+    GLsizeiptr uniform_alignment = 256;
+    size_t frame_idx = 0;
+    GLintptr frame_offset = 0;
+    std::array<GLsync, FRAMES_IN_FLIGHT> frame_fences{};
+};
@@ -1,14 +1,19 @@
 #pragma once
+#include <array>
+#include <cstdint>
 #include <iostream>
 #include <optional>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <sstream>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
 #include "stb_image.h"
+#include "GLResource.h"
+#include "GLState.h"
 #include "Shader.h"
 
 
@@ -27,23 +32,77 @@ public:
     GLfloat height_coef;
 };
 
+struct TextureUnits {
+public:
+    static constexpr GLuint DIFFUSE_MAP = 0;
+    static constexpr GLuint SPECULAR_MAP = 1;
+    static constexpr GLuint NORMAL_MAP = 2;
+    static constexpr GLuint DEPTH_MAP = 3;
+    static constexpr GLuint SHADOW_MAP = 5;
+    static constexpr GLuint SHADOW_CUBE_MAP = 6;
+    static constexpr GLuint LAYER_STRIDE = 8;
+
+public:
+    TextureUnits() = delete;
+
+    static std::optional<GLuint> GetTextureUnit(std::string_view, GLuint = 0);
+    static std::optional<GLuint> GetSamplerUnit(std::string_view);
+};
+
+
+enum class SamplerType : uint8_t {
+    SURFACE,
+    SHADOW_MAP,
+    SHADOW_CUBE_MAP,
+    COUNT
+};
+
+class TextureSampler {
+public:
+    TextureSampler() = delete;
+
+    static GLuint GetSampler(SamplerType);
+    static void BindSamplers();
+    static void BindTextureUnits(const ShaderPipe&);
+
+private:
+    static GLSampler CreateSampler(SamplerType);
+    static std::optional<SamplerType> GetSamplerType(GLuint);
+};
+
+
+struct TextureUniformNames {
+public:
+    explicit TextureUniformNames(const std::string&);
+
+public:
+    UniformName name;
+    UniformName texture;
+    UniformName flare;
+    UniformName diff_coef;
+    UniformName height_coef;
+};
+
 class Texture {
 public:
     static constexpr std::string_view TEXTURE = "texture_data";
     static constexpr std::string_view CUBE_MAP_DATA = "cube_map_data";
 
 public:
+    Texture() = default;
+    Texture(Texture&&) = default;
+    Texture& operator=(Texture&&) = default;
     virtual ~Texture() {}
     virtual void LoadTexture(const std::vector<std::string>&, const std::string&, bool) {};
     std::optional<GLuint> GetTextureID() const;
-    std::optional <std::string> GetType() const;
+    const std::optional<std::string>& GetType() const;
     void SetTextureParametrs(const TextureParametrs&);
-    virtual void UseTexture(const ShaderPipe&, const std::string, GLuint) const {};
+    virtual void UseTexture(const ShaderPipe&, const TextureUniformNames&, GLuint) const {};
 
 protected:
     std::optional<TextureParametrs> texture_params;
     std::optional<std::string> type;
-    std::optional<GLuint> texture_id;
+    GLTexture texture_handle;
 };
 
 
@@ -62,7 +121,7 @@ public:
     Texture2D() = default;
     void LoadTexture(const std::vector<std::string>&, const std::string&, bool = false) override;
     void GenShadowTexture(GLuint, GLuint);
-    void UseTexture(const ShaderPipe& shader_program, const std::string, GLuint) const override;
+    void UseTexture(const ShaderPipe& shader_program, const TextureUniformNames&, GLuint) const override;
 };
 
 
@@ -74,6 +133,7 @@ void BindShadowTexture(const Texture2D&, GLuint);
 class TextureCube : public Texture {
 public:
     friend void BindShadowCubeTexture(const TextureCube&, GLuint);
+    friend void BindShadowCubeFace(const TextureCube&, GLuint, GLuint);
 
 public:
     static constexpr std::string_view SKYBOX_MAP = "skybox_map";
@@ -83,7 +143,8 @@ public:
     void LoadTexture(const std::vector<std::string>&, const std::string&, bool = false) override;
     void GenShadowTexture(GLuint, GLuint);
     void UseTextureForShadowRendering() const;
-    void UseTexture(const ShaderPipe&, const std::string, GLuint) const;
+    void UseTexture(const ShaderPipe&, const TextureUniformNames&, GLuint) const override;
 };
 
 void BindShadowCubeTexture(const TextureCube&, GLuint);
+void BindShadowCubeFace(const TextureCube&, GLuint, GLuint);
@@ -0,0 +1,79 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include "StreamBuffer.h"
+
+
+/* Uniform-блок, общий для всех шейдерных программ через точку привязки. Содержимое собирается на CPU
+   и каждый проход копируется в кольцевой буфер кадра, точка привязки указывает на записанный диапазон */
+class UniformBuffer {
+public:
+    static constexpr std::string_view CAMERA_PARAM = "CameraParam";
+    static constexpr std::string_view LIGHT_DIRECTED_PARAM = "LightDirectedParam";
+    static constexpr std::string_view LIGHT_POINT_PARAM = "LightPointParam";
+
+    static constexpr GLuint CAMERA_PARAM_BINDING = 0;
+    static constexpr GLuint LIGHT_DIRECTED_PARAM_BINDING = 1;
+    static constexpr GLuint LIGHT_POINT_PARAM_BINDING = 2;
+
+public:
+    UniformBuffer() = default;
+    void CreateUniformBuffer(GLsizeiptr, GLuint);
+    GLuint GetBinding() const;
+    void UpdateUniformBuffer(GLintptr, GLsizeiptr, const void*);
+    void CommitUniformBuffer(StreamBuffer&) const;
+
+    static std::optional<GLuint> GetBindingPoint(const std::string&);
+
+private:
+    std::vector<GLubyte> buffer_data;
+    GLuint binding_point = 0;
+};
+
+
+/* Раскладки блоков по правилам std140, повторяют объявления в шейдерах */
+struct CameraParamStd140 {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 light_space;
+    glm::vec3 view_position;
+    GLfloat padding_view_position;
+};
+
+struct LightStd140 {
+    glm::vec3 position;
+    GLfloat attenuation_const;
+    glm::vec3 direction;
+    GLfloat attenuation_lin;
+    glm::vec3 ambient;
+    GLfloat attenuation_quad;
+    glm::vec3 diffuse;
+    GLfloat padding_diffuse;
+    glm::vec3 specular;
+    GLfloat padding_specular;
+};
+
+struct LightDirectedParamStd140 {
+    LightStd140 light_directed;
+};
+
+struct LightPointParamStd140 {
+    static constexpr size_t MAX_CNT_LIGHT_POINT = 8;
+
+    GLfloat far_plane;
+    GLfloat padding_far_plane[3];
+    LightStd140 light_point[MAX_CNT_LIGHT_POINT];
+};
+
+static_assert(offsetof(CameraParamStd140, view_position) == 192 && sizeof(CameraParamStd140) == 208);
+static_assert(offsetof(LightStd140, specular) == 64 && sizeof(LightStd140) == 80);
+static_assert(offsetof(LightPointParamStd140, light_point) == 16);
@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <functional>
 #include <iostream>
 #include <sstream>
@@ -9,6 +10,7 @@
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 
+#include "AllocationCounter.h"
 #include "Scene.h"
 #include "Camera.h"
 
@@ -41,6 +43,19 @@ private:
 
 	GLfloat delta_time = 0.0f;
 	GLfloat last_frame = 0.0f;
+	GLfloat last_stats_report = 0.0f;
+	size_t cnt_frames = 0;
+	size_t render_allocations = 0;
+
+	//     ,        GPU
+	static constexpr size_t CNT_VERTEX_QUERIES = 3;
+	// ,      ,  
+	std::array<GLQuery, CNT_VERTEX_QUERIES> vertex_queries;
+	std::array<bool, CNT_VERTEX_QUERIES> vertex_queries_pending{};
+	bool vertex_query_active = false;
+	size_t vertex_query_idx = 0;
+	GLuint64 vertex_invocations = 0;
+	size_t cnt_vertex_query_frames = 0;
 
 public:
 	static constexpr GLuint SCR_WIDTH = 1200;
@@ -49,13 +64,21 @@ public:
 	static constexpr GLuint SHADOW_MAP_HEIGHT = 4069;
 	static constexpr GLuint SHADOW_CUBE_MAP_WIDTH = 2048;
 	static constexpr GLuint SHADOW_CUBE_MAP_HEIGHT = 2048;
+	static constexpr GLfloat STATS_REPORT_INTERVAL = 1.0f;
 
 public:
 	Window() = default;
 
 	void Initialize(const std::string& title);
-	void Rendering(Scene &scene, std::vector<ShaderPipe> shaders_shadow, std::vector<ShaderPipe> shaders_scene);
+	void Rendering(Scene &scene, std::vector<ShaderPipe> shaders_shadow, std::vector<ShaderPipe> shaders_shadow_cube,
+	               std::vector<ShaderPipe> shaders_scene);
 	void KeyboardInput();
+	void ReportFrameStats(GLfloat current_frame);
+	void BeginVertexQuery();
+	void EndVertexQuery();
+	void DeleteVertexQueries();
+
+	static bool IsVertexQuerySupported();
 };
 
 
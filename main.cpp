@@ -1,4 +1,6 @@
-﻿#include <iostream>
+﻿#include <algorithm>
+#include <iostream>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -8,6 +10,8 @@
 
 #include "libs/Initializer.h"
 #include "libs/Light.h"
+#include "libs/BakedMesh.h"
+#include "libs/MeshImporter.h"
 #include "libs/Model.h"
 #include "libs/Texture.h"
 #include "libs/Scene.h"
@@ -22,7 +26,36 @@ int main(int argc, char **argv) {
 	window.Initialize("test");
 	GLADLoader();
 
-	// Загружаем шейдеры сцены
+	// Создаем источники света, их количество нужно для специализации шейдеров
+
+	glm::vec3 light_point_position(2.0f, 3.0f, 1.5f);
+	glm::vec3 light_directed_position(2.0f, 3.0f, 1.5f);
+
+	LightPoint light_point_param{
+		light_point_position,
+		glm::vec3(0.05f, 0.05f, 0.05f),
+		glm::vec3(0.4f, 0.4f, 0.4f),
+		glm::vec3(0.5f, 0.5f, 0.5f),
+		0.1, 0.09, 0.032 };
+
+	LightDirected light_directed{
+		light_directed_position,
+		glm::vec3(-0.2f, -1.0f, -0.3f),
+		glm::vec3(0.05f, 0.05f, 0.05f),
+		glm::vec3(0.4f, 0.4f, 0.4f),
+		glm::vec3(0.5f, 0.5f, 0.5f) };
+
+	std::vector<LightPoint> lights_point;
+	lights_point.push_back(light_point_param);
+
+	// Загружаем шейдеры сцены и теней, специализируя их под материал и количество источников света
+
+	size_t cnt_light_point = std::clamp<size_t>(lights_point.size(), 1, LightPointParamStd140::MAX_CNT_LIGHT_POINT);
+	ShaderDefines scene_defines{ { "CNT_LIGHT_POINT", std::to_string(cnt_light_point) } };
+
+	// У пластикового куба только диффузная карта, блики берутся из нее
+	ShaderDefines plastic_cube_defines = scene_defines;
+	plastic_cube_defines["CNT_SPECULAR_MAP"] = "0";
 
 	std::vector<ShaderLoadInfo> shareds_cube_info = { {"./scr/Shaders/ModelVertexShader.hlsl", GL_VERTEX_SHADER},
 												      {"./scr/Shaders/ModelFragmentShader.hlsl", GL_FRAGMENT_SHADER} };
@@ -36,10 +69,23 @@ int main(int argc, char **argv) {
 	std::vector<ShaderLoadInfo> shareds_floor_info = { {"./scr/Shaders/FloorVertexShader.hlsl", GL_VERTEX_SHADER},
 													   {"./scr/Shaders/FloorFragmentShader.hlsl", GL_FRAGMENT_SHADER} };
 
-	ShaderPipe shader_cube_program = CreateShaderProgram(shareds_cube_info.begin(), shareds_cube_info.end());
-	ShaderPipe shader_plastic_cube_program = CreateShaderProgram(shareds_plastic_cube_info.begin(), shareds_plastic_cube_info.end());
-	ShaderPipe shader_light_program = CreateShaderProgram(shareds_light_info.begin(), shareds_light_info.end());
-	ShaderPipe shareds_floor_program = CreateShaderProgram(shareds_floor_info.begin(), shareds_floor_info.end());
+	std::vector<ShaderLoadInfo> shareds_shadow_info = { {"./scr/Shaders/ShadowVertexShader.hlsl", GL_VERTEX_SHADER},
+														{"./scr/Shaders/ShadowFragmentShader.hlsl", GL_FRAGMENT_SHADER} };
+
+	std::vector<ShaderLoadInfo> shareds_shadow_cube_info = { {"./scr/Shaders/ShadowCubeVertexShader.hlsl", GL_VERTEX_SHADER},
+															 {"./scr/Shaders/ShadowCubeFragmentShader.hlsl", GL_FRAGMENT_SHADER} };
+
+	// Шейдеры только отправляются на сборку, драйвер компилирует их пока грузятся текстуры и геометрия
+
+	ShaderCompiler shader_compiler;
+
+	ShaderPipe shader_cube_program = shader_compiler.SubmitShaderProgram(shareds_cube_info.begin(), shareds_cube_info.end(), scene_defines);
+	ShaderPipe shader_plastic_cube_program = shader_compiler.SubmitShaderProgram(shareds_plastic_cube_info.begin(),
+	                                                                             shareds_plastic_cube_info.end(), plastic_cube_defines);
+	ShaderPipe shader_light_program = shader_compiler.SubmitShaderProgram(shareds_light_info.begin(), shareds_light_info.end());
+	ShaderPipe shareds_floor_program = shader_compiler.SubmitShaderProgram(shareds_floor_info.begin(), shareds_floor_info.end(), scene_defines);
+	ShaderPipe shader_shadow_program = shader_compiler.SubmitShaderProgram(shareds_shadow_info.begin(), shareds_shadow_info.end());
+	ShaderPipe shader_shadow_cube_program = shader_compiler.SubmitShaderProgram(shareds_shadow_cube_info.begin(), shareds_shadow_cube_info.end());
 
 	std::vector<ShaderPipe> shaders_scene;
 	shaders_scene.push_back(shader_cube_program);
@@ -153,93 +199,73 @@ int main(int argc, char **argv) {
 
 	// Загружаем текстуры
 
-	Texture2D texture;
+	std::vector<Texture2D> texture_cube(1);
+	texture_cube[0].LoadTexture({ "./textures/Cube/Plastic_001_COLOR.jpg" }, std::string(Texture2D::DIFFUSE_MAP));
+	texture_cube[0].SetTextureParametrs({ 256, 0.5 });
+
 
-	std::vector<Texture2D> texture_cube;
-	texture.LoadTexture({ "./textures/Cube/Plastic_001_COLOR.jpg" }, std::string(Texture2D::DIFFUSE_MAP));
-	texture.SetTextureParametrs({ 256, 0.5 });
-	texture_cube.push_back(texture);
+	std::vector<Texture2D> textures_column(4);
+	textures_column[0].LoadTexture({ "./textures/bricks2.jpg" }, std::string(Texture2D::DIFFUSE_MAP));
+	textures_column[0].SetTextureParametrs({ 1, 0.5 });
 
+	textures_column[1].LoadTexture({ "./textures/bricks2.jpg" }, std::string(Texture2D::SPECULAR_MAP));
+	textures_column[1].SetTextureParametrs({ 16, 0.5 });
 
-	std::vector<Texture2D> textures_column;
-	texture.LoadTexture({ "./textures/bricks2.jpg" }, std::string(Texture2D::DIFFUSE_MAP));
-	texture.SetTextureParametrs({ 1, 0.5 });
-	textures_column.push_back(texture);
+	textures_column[2].LoadTexture({ "./textures/bricks2_normal.jpg" }, std::string(Texture2D::NORMAL_MAP));
+	textures_column[2].SetTextureParametrs({ 16, 0.5 });
 
-	texture.LoadTexture({ "./textures/bricks2.jpg" }, std::string(Texture2D::SPECULAR_MAP));
-	texture.SetTextureParametrs({ 16, 0.5 });
-	textures_column.push_back(texture);
+	textures_column[3].LoadTexture({ "./textures/bricks2_disp.jpg" }, std::string(Texture2D::DEPTH_MAP));
+	textures_column[3].SetTextureParametrs({ 0.0, 0.0, 0.1 });
 
-	texture.LoadTexture({ "./textures/bricks2_normal.jpg" }, std::string(Texture2D::NORMAL_MAP));
-	textures_column.push_back(texture);
 
-	texture.LoadTexture({ "./textures/bricks2_disp.jpg" }, std::string(Texture2D::DEPTH_MAP));
-	texture.SetTextureParametrs({ 0.0, 0.0, 0.1 });
-	textures_column.push_back(texture);
+	std::vector<Texture2D> textures_floor(3);
+	textures_floor[0].LoadTexture({ "./textures/Floor/Stone_Wall_007_COLOR.jpg" }, std::string(Texture2D::DIFFUSE_MAP));
+	textures_floor[0].SetTextureParametrs({ 0.0, 0.0, 0.1 });
 
+	textures_floor[1].LoadTexture({ "./textures/Floor/Stone_Wall_007_NORM.jpg" }, std::string(Texture2D::NORMAL_MAP));
+	textures_floor[1].SetTextureParametrs({ 0.0, 0.0, 0.1 });
 
-	std::vector<Texture2D> textures_floor;
-	texture.LoadTexture({ "./textures/Floor/Stone_Wall_007_COLOR.jpg" }, std::string(Texture2D::DIFFUSE_MAP));
-	textures_floor.push_back(texture);
+	textures_floor[2].LoadTexture({ "./textures/Floor/Stone_Wall_007_DEPTH.png" }, std::string(Texture2D::DEPTH_MAP));
+	textures_floor[2].SetTextureParametrs({ 0.0, 0.0, 0.1 });
 
-	texture.LoadTexture({ "./textures/Floor/Stone_Wall_007_NORM.jpg" }, std::string(Texture2D::NORMAL_MAP));
-	textures_floor.push_back(texture);
 
-	texture.LoadTexture({ "./textures/Floor/Stone_Wall_007_DEPTH.png" }, std::string(Texture2D::DEPTH_MAP));
-	texture.SetTextureParametrs({ 0.0, 0.0, 0.1 });
-	textures_floor.push_back(texture);
+	// Создаем материалы, общие для всех объектов с одинаковым набором текстур
+
+	MaterialHandle material_plastic = Material::CreateMaterial(std::move(texture_cube));
+	MaterialHandle material_column = Material::CreateMaterial(std::move(textures_column));
+	MaterialHandle material_floor = Material::CreateMaterial(std::move(textures_floor));
+	MaterialHandle material_light = Material::CreateMaterial({});
 
 
 	// Создаем объекты графических примитивов
 
-	Mesh plastic_cube{ creater_cube.CreateObject(), indexes_vertex_coords_cube, texture_cube };
-	plastic_cube.InitializeMesh();
+	Mesh plastic_cube{ creater_cube.CreateObject(), material_plastic };
+	plastic_cube.InitializeMesh(MeshResidency::DISCARD);
 
-	Mesh cube{ creater_cube.CreateObject(), indexes_vertex_coords_cube, textures_column };
-	cube.InitializeMesh();
+	Mesh cube{ creater_cube.CreateObject(), material_column };
+	cube.InitializeMesh(MeshResidency::DISCARD);
 
-	Mesh column{ creater_column.CreateObject(), indexes_vertex_coords_cube, textures_column };
-	column.InitializeMesh();
+	Mesh column{ creater_column.CreateObject(), material_column };
+	column.InitializeMesh(MeshResidency::DISCARD);
 
-	Mesh floor{ creater_floor.CreateObject(), indexes_vertex_coords_floor, textures_floor, false };
-	floor.InitializeMesh();
+	Mesh floor{ creater_floor.CreateObject(), material_floor, false };
+	floor.InitializeMesh(MeshResidency::POSITIONS);
 
-	Mesh light{ creater_cube.CreateObject(), indexes_vertex_coords_cube, std::vector<Texture2D>{} };
-	light.InitializeMesh();
+	Mesh light{ creater_cube.CreateObject(), material_light };
+	light.InitializeMesh(MeshResidency::DISCARD);
 
 
 	// Добавляем объеты в пул отрисовки
 
 	std::vector<Mesh> meshs_scene;
-	meshs_scene.push_back(cube);
-	meshs_scene.push_back(plastic_cube);
-	meshs_scene.push_back(column);
+	meshs_scene.push_back(std::move(cube));
+	meshs_scene.push_back(std::move(plastic_cube));
 	meshs_scene.push_back(column);
 	meshs_scene.push_back(column);
-	meshs_scene.push_back(floor);
-	meshs_scene.push_back(light);
-
-	// Создаем источник направленного света
-
-	glm::vec3 light_point_position(2.0f, 3.0f, 1.5f);
-	glm::vec3 light_directed_position(2.0f, 3.0f, 1.5f);
-
-	LightPoint light_point_param{
-		light_point_position,
-		glm::vec3(0.05f, 0.05f, 0.05f),
-		glm::vec3(0.4f, 0.4f, 0.4f),
-		glm::vec3(0.5f, 0.5f, 0.5f),
-		0.1, 0.09, 0.032 };
-
-	LightDirected light_directed{
-		light_directed_position,
-		glm::vec3(-0.2f, -1.0f, -0.3f),
-		glm::vec3(0.05f, 0.05f, 0.05f),
-		glm::vec3(0.4f, 0.4f, 0.4f),
-		glm::vec3(0.5f, 0.5f, 0.5f) };
-
-	std::vector<LightPoint> lights_point;
-	lights_point.push_back(light_point_param);
+	meshs_scene.push_back(std::move(column));
+	meshs_scene.push_back(std::move(floor));
+	meshs_scene.push_back(std::move(light));
+	Mesh::PrintMemoryStats();
 
 	// Задаем матрицы перевода объектов в мировое пространство
 
@@ -252,44 +278,80 @@ int main(int argc, char **argv) {
 	transforms.emplace_back(glm::vec3(0.0f, -2.0f, 0.0f));
 	transforms.emplace_back(light_directed_position, glm::vec3(0.2f));
 
-	// Загружаем шейдеры для создания теней
+	// Загружаем модели OBJ и glTF, переданные в командной строке, через кэш запеченных мешей
+
+	for (int idx = 1; idx < argc; ++idx) {
+		std::shared_ptr<const BakedMesh> baked_model = BakedMesh::LoadCachedMesh(argv[idx]);
+		if (!baked_model) {
+			continue;
+		}
+		Mesh model{ std::move(baked_model), material_column };
+		model.InitializeMesh(MeshResidency::DISCARD);
+		meshs_scene.push_back(std::move(model));
+		shaders_scene.push_back(shader_cube_program);
+		transforms.emplace_back();
+	}
+	if (argc > 1) {
+		MeshImporter::PrintStats();
+		Mesh::PrintMemoryStats();
+	}
+
+	// Дожидаемся окончания сборки шейдеров, не блокируя обработку событий окна
+
+	while (!shader_compiler.IsReady()) {
+		glfwWaitEventsTimeout(ShaderCompiler::POLL_INTERVAL);
+	}
+	if (!shader_compiler.Finish()) {
+		std::cerr << "ERROR::MAIN::SHADER_PROGRAM_NOT_LINKED" << std::endl;
+		glfwTerminate();
+		return -1;
+	}
+	ShaderCache::PrintStats();
 
-	std::vector<ShaderLoadInfo> shareds_shadow_info = { {"./scr/Shaders/ShadowVertexShader.hlsl", GL_VERTEX_SHADER},
-														{"./scr/Shaders/ShadowFragmentShader.hlsl", GL_FRAGMENT_SHADER} };
+	std::vector<ShaderPipe> shaders_shadow{ shader_shadow_program };
+	std::vector<ShaderPipe> shaders_shadow_cube{ shader_shadow_cube_program };
 
+	// Сопоставляем текстуры объектов с параметрами шейдерных программ
 
-	ShaderPipe shader_shadow_program = CreateShaderProgram(shareds_shadow_info.begin(), shareds_shadow_info.end());
+	for (size_t idx = 0; idx < meshs_scene.size(); ++idx) {
+		meshs_scene[idx].BindShaderPipe(shaders_scene[idx]);
+		meshs_scene[idx].BindShaderPipe(shader_shadow_program);
+		meshs_scene[idx].BindShaderPipe(shader_shadow_cube_program);
+	}
 
-	std::vector<ShaderPipe> shaders_shadow{ shader_shadow_program };
-	std::vector<ShaderPipe> shaders_shadow_cube{ };
+	// Сэмплеры программ один раз направляем в фиксированные текстурные блоки
 
+	TextureSampler::BindSamplers();
+	for (const auto &shader_program : shaders_scene) {
+		TextureSampler::BindTextureUnits(shader_program);
+	}
+	TextureSampler::BindTextureUnits(shader_shadow_program);
+	TextureSampler::BindTextureUnits(shader_shadow_cube_program);
 
-	// Создаем текстуру для карт глубины и связываем ее с соответсвующем фреймбуфером
 
-	GLuint shadow_FBO;
-	glGenFramebuffers(1, &shadow_FBO);
+	// Создаем текстуру для карт глубины и связываем ее с соответсвующем фреймбуфером
 
-	GLuint shadow_cube_FBO;
-	glGenFramebuffers(1, &shadow_cube_FBO);
+	GLFramebuffer shadow_FBO = GLFramebuffer::Create();
+	GLFramebuffer shadow_cube_FBO = GLFramebuffer::Create();
 
 	Texture2D shadow_map;
 	shadow_map.GenShadowTexture(Window::SHADOW_MAP_WIDTH, Window::SHADOW_MAP_HEIGHT);
 
 	TextureCube shadow_cube_map;
 	std::vector<TextureCube> shadow_cube_maps;
-	BindShadowTexture(shadow_map, shadow_FBO);
+	BindShadowTexture(shadow_map, shadow_FBO.Get());
 
 	shadow_cube_map.GenShadowTexture(Window::SHADOW_CUBE_MAP_WIDTH, Window::SHADOW_CUBE_MAP_HEIGHT);
-	BindShadowCubeTexture(shadow_cube_map, shadow_cube_FBO);
-	shadow_cube_maps.push_back(shadow_cube_map);
+	BindShadowCubeTexture(shadow_cube_map, shadow_cube_FBO.Get());
+	shadow_cube_maps.push_back(std::move(shadow_cube_map));
 
 	// Инициализируем объект сцены
 
-	Scene scene{ meshs_scene, shadow_map, shadow_FBO, shadow_cube_maps, shadow_cube_FBO, lights_point, light_directed, transforms };
+	Scene scene{ meshs_scene, shadow_map, shadow_FBO.Get(), shadow_cube_maps, shadow_cube_FBO.Get(), lights_point, light_directed, transforms };
 
 	// Рендерим полученную сцену
 
-	window.Rendering(scene, shaders_shadow, shaders_scene);
+	window.Rendering(scene, shaders_shadow, shaders_shadow_cube, shaders_scene);
 
 	return 0;
 }
@@ -0,0 +1,129 @@
+﻿#include "../libs/AllocationCounter.h"
+
+#if defined(_DEBUG) && defined(_WIN32)
+#include <malloc.h>
+#endif
+
+
+std::atomic<size_t> AllocationCounter::cnt_allocations{ 0 };
+
+size_t AllocationCounter::GetCount() {
+    return cnt_allocations.load(std::memory_order_relaxed);
+}
+
+void AllocationCounter::AddAllocation() {
+    cnt_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+#ifdef _DEBUG
+static void* CountedAllocate(size_t size) {
+    AllocationCounter::AddAllocation();
+    return std::malloc(size ? size : 1);
+}
+
+static void* CountedAllocateAligned(size_t size, std::align_val_t alignment) {
+    AllocationCounter::AddAllocation();
+    size_t align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, align);
+#else
+    return std::aligned_alloc(align, (size + align - 1) / align * align + (size ? 0 : align));
+#endif
+}
+
+static void FreeAligned(void *memory) {
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+
+void* operator new(size_t size) {
+    if (void *memory = CountedAllocate(size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    if (void *memory = CountedAllocateAligned(size, alignment)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return CountedAllocateAligned(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return CountedAllocateAligned(size, alignment);
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void *memory, size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void *memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept {
+    FreeAligned(memory);
+}
+
+void operator delete[](void *memory, std::align_val_t) noexcept {
+    FreeAligned(memory);
+}
+
+void operator delete(void *memory, size_t, std::align_val_t) noexcept {
+    FreeAligned(memory);
+}
+
+void operator delete[](void *memory, size_t, std::align_val_t) noexcept {
+    FreeAligned(memory);
+}
+
+void operator delete(void *memory, std::align_val_t, const std::nothrow_t&) noexcept {
+    FreeAligned(memory);
+}
+
+void operator delete[](void *memory, std::align_val_t, const std::nothrow_t&) noexcept {
+    FreeAligned(memory);
+}
+#endif
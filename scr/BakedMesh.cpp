@@ -0,0 +1,348 @@
+﻿#include "../libs/BakedMesh.h"
+#include "../libs/MeshImporter.h"
+#include "../libs/MeshSimplifier.h"
+
+
+BakedMesh::BakedMesh(MappedFile mapped_file, const BakedMeshHeader& header, std::vector<MeshLod> lods)
+    : mapped_file(std::move(mapped_file)), header(header), lods(std::move(lods)) {}
+
+std::shared_ptr<const BakedMesh> BakedMesh::LoadBakedMesh(const std::filesystem::path& path) {
+    MappedFile mapped_file(path);
+    if (!mapped_file.IsOpen()) {
+        return nullptr;
+    }
+
+    BakedMeshHeader header;
+    if (mapped_file.GetSize() < sizeof(header)) {
+        std::cerr << "ERROR::BAKED_MESH::INVALID_HEADER" << std::endl;
+        return nullptr;
+    }
+    std::memcpy(&header, mapped_file.GetData(), sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION) {
+        std::cerr << "ERROR::BAKED_MESH::UNSUPPORTED_VERSION" << std::endl;
+        return nullptr;
+    }
+    if (!ValidateHeader(header, mapped_file.GetSize())) {
+        std::cerr << "ERROR::BAKED_MESH::INVALID_LAYOUT" << std::endl;
+        return nullptr;
+    }
+    if (!ValidateVertexFormat(header, mapped_file.GetData())) {
+        std::cerr << "ERROR::BAKED_MESH::VERTEX_FORMAT_MISMATCH" << std::endl;
+        return nullptr;
+    }
+
+    std::vector<MeshLod> lods;
+    for (uint32_t idx = 0; idx < header.cnt_lods; ++idx) {
+        BakedMeshLod baked_lod;
+        std::memcpy(&baked_lod, mapped_file.GetData() + header.lods_offset + idx * sizeof(baked_lod), sizeof(baked_lod));
+        if (uint64_t(baked_lod.first_index) + baked_lod.cnt_indexes > header.cnt_indexes || baked_lod.cnt_indexes % 3 != 0 ||
+            (idx == 0 && baked_lod.first_index != 0)) {
+            std::cerr << "ERROR::BAKED_MESH::INVALID_LOD" << std::endl;
+            return nullptr;
+        }
+        lods.push_back({ baked_lod.first_index, static_cast<GLsizei>(baked_lod.cnt_indexes), baked_lod.error });
+    }
+    if (!ValidateIndexes(header, mapped_file.GetData())) {
+        std::cerr << "ERROR::BAKED_MESH::INDEX_OUT_OF_RANGE" << std::endl;
+        return nullptr;
+    }
+
+    return std::shared_ptr<const BakedMesh>(new BakedMesh(std::move(mapped_file), header, std::move(lods)));
+}
+
+std::shared_ptr<const BakedMesh> BakedMesh::LoadCachedMesh(const std::filesystem::path& source_path) {
+    auto start_time = std::chrono::steady_clock::now();
+    std::filesystem::path cache_path = GetCachePath(source_path);
+
+    // Кэш действителен, пока он не старше исходного файла и записан текущей версией формата
+    std::error_code error;
+    auto source_time = std::filesystem::last_write_time(source_path, error);
+    bool source_exists = !error;
+    auto cache_time = std::filesystem::last_write_time(cache_path, error);
+    if (!error && (!source_exists || cache_time >= source_time) && IsCurrentVersion(cache_path)) {
+        if (auto baked_mesh = LoadBakedMesh(cache_path)) {
+            std::chrono::duration<double, std::milli> load_time = std::chrono::steady_clock::now() - start_time;
+            double size_mb = baked_mesh->GetSize() / (1024.0 * 1024.0);
+            std::cout << "BAKED_MESH::LOADED " << source_path.filename().string() << " " << size_mb << " MB, "
+                      << baked_mesh->GetVertexCount() << " VERTEXES, " << baked_mesh->GetLods().size() << " LODS in "
+                      << load_time.count() << " ms" << std::endl;
+            return baked_mesh;
+        }
+    }
+
+    std::optional<MeshData> mesh_data = MeshImporter::LoadMesh(source_path);
+    if (!mesh_data || !SaveBakedMesh(cache_path, *mesh_data, MeshSimplifier::GenerateLods(*mesh_data))) {
+        return nullptr;
+    }
+    return LoadBakedMesh(cache_path);
+}
+
+bool BakedMesh::SaveBakedMesh(const std::filesystem::path& path, const MeshData& mesh_data,
+                              const std::vector<MeshLodData>& lods, VertexPacking vertex_packing) {
+    const std::vector<Vertex> &vertexes = mesh_data.vertexes;
+    std::vector<GLuint> indexes = mesh_data.indexes;
+    if (indexes.empty()) {
+        indexes.resize(vertexes.size());
+        std::iota(indexes.begin(), indexes.end(), 0);
+    }
+    if (vertex_packing == VertexPacking::AUTO) {
+        vertex_packing = Mesh::ChooseVertexPacking(vertexes);
+    }
+    VertexFormat vertex_format = Mesh::GetVertexFormat(vertex_packing);
+    std::vector<VertexAttribute> vertex_attributes;
+    std::copy_if(vertex_format.attributes.begin(), vertex_format.attributes.end(), std::back_inserter(vertex_attributes),
+                 [](const VertexAttribute &attribute) { return attribute.divisor == 0; });
+
+    // Все LOD лежат в одном блоке индексов, LOD 0 всегда первый
+    std::vector<BakedMeshLod> baked_lods{ { 0, static_cast<uint32_t>(indexes.size()), 0.0f, 0 } };
+    for (const auto &lod : lods) {
+        baked_lods.push_back({ static_cast<uint32_t>(indexes.size()), static_cast<uint32_t>(lod.indexes.size()), lod.error, 0 });
+        indexes.insert(indexes.end(), lod.indexes.begin(), lod.indexes.end());
+    }
+
+    BakedMeshHeader header{};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.vertex_packing = static_cast<uint8_t>(vertex_packing);
+    header.cnt_attributes = static_cast<uint8_t>(vertex_attributes.size());
+    header.vertex_stride = static_cast<uint32_t>(vertex_format.stride);
+    header.index_type = vertexes.size() <= std::numeric_limits<GLushort>::max() + size_t(1) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    header.cnt_lods = static_cast<uint32_t>(baked_lods.size());
+    header.cnt_vertexes = vertexes.size();
+    header.cnt_indexes = indexes.size();
+
+    glm::vec3 bounds_min(0.0f);
+    glm::vec3 bounds_max(0.0f);
+    std::vector<glm::vec3> positions;
+    positions.reserve(vertexes.size());
+    for (const auto &vertex : vertexes) {
+        bounds_min = positions.empty() ? vertex.position : glm::min(bounds_min, vertex.position);
+        bounds_max = positions.empty() ? vertex.position : glm::max(bounds_max, vertex.position);
+        positions.push_back(vertex.position);
+    }
+    std::memcpy(header.bounds_min, &bounds_min, sizeof(header.bounds_min));
+    std::memcpy(header.bounds_max, &bounds_max, sizeof(header.bounds_max));
+
+    std::vector<char> vertex_blob;
+    if (vertex_packing == VertexPacking::PACKED) {
+        std::vector<PackedVertex> packed_vertexes = Mesh::PackVertexes(vertexes);
+        const auto *bytes = reinterpret_cast<const char*>(std::data(packed_vertexes));
+        vertex_blob.assign(bytes, bytes + packed_vertexes.size() * sizeof(PackedVertex));
+    } else {
+        const auto *bytes = reinterpret_cast<const char*>(std::data(vertexes));
+        vertex_blob.assign(bytes, bytes + vertexes.size() * sizeof(Vertex));
+    }
+
+    std::vector<char> index_blob;
+    if (header.index_type == GL_UNSIGNED_SHORT) {
+        std::vector<GLushort> short_indexes(indexes.begin(), indexes.end());
+        const auto *bytes = reinterpret_cast<const char*>(std::data(short_indexes));
+        index_blob.assign(bytes, bytes + short_indexes.size() * sizeof(GLushort));
+    } else {
+        const auto *bytes = reinterpret_cast<const char*>(std::data(indexes));
+        index_blob.assign(bytes, bytes + indexes.size() * sizeof(GLuint));
+    }
+
+    header.attributes_offset = AlignOffset(sizeof(header), alignof(BakedVertexAttribute));
+    header.lods_offset = AlignOffset(header.attributes_offset + vertex_attributes.size() * sizeof(BakedVertexAttribute), alignof(BakedMeshLod));
+    header.vertexes_offset = AlignOffset(header.lods_offset + baked_lods.size() * sizeof(BakedMeshLod), BLOB_ALIGNMENT);
+    header.positions_offset = AlignOffset(header.vertexes_offset + vertex_blob.size(), BLOB_ALIGNMENT);
+    header.indexes_offset = AlignOffset(header.positions_offset + positions.size() * sizeof(glm::vec3), BLOB_ALIGNMENT);
+    header.file_size = header.indexes_offset + index_blob.size();
+
+    std::error_code error;
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), error);
+        if (error) {
+            std::cerr << "ERROR::BAKED_MESH::DIRECTORY_NOT_CREATED" << std::endl;
+            return false;
+        }
+    }
+
+    // Пишем во временный файл, чтобы прерванная запись не оставила битый кэш
+    std::filesystem::path temporary_path = path;
+    temporary_path += ".tmp";
+    {
+        std::ofstream baked_file(temporary_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!baked_file.is_open()) {
+            std::cerr << "ERROR::BAKED_MESH::FILE_NOT_SUCCESFULLY_WRITTEN" << std::endl;
+            return false;
+        }
+
+        auto write_at = [&baked_file](uint64_t offset, const void *data, size_t size) {
+            static const char padding[BLOB_ALIGNMENT] = {};
+            uint64_t position = static_cast<uint64_t>(baked_file.tellp());
+            baked_file.write(padding, static_cast<std::streamsize>(offset - position));
+            baked_file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        };
+
+        write_at(0, &header, sizeof(header));
+        for (const auto &attribute : vertex_attributes) {
+            BakedVertexAttribute baked_attribute{ attribute.location, attribute.size, attribute.type, attribute.normalized, attribute.offset };
+            write_at(static_cast<uint64_t>(baked_file.tellp()), &baked_attribute, sizeof(baked_attribute));
+        }
+        write_at(header.lods_offset, std::data(baked_lods), baked_lods.size() * sizeof(BakedMeshLod));
+        write_at(header.vertexes_offset, std::data(vertex_blob), vertex_blob.size());
+        write_at(header.positions_offset, std::data(positions), positions.size() * sizeof(glm::vec3));
+        write_at(header.indexes_offset, std::data(index_blob), index_blob.size());
+        if (!baked_file) {
+            std::cerr << "ERROR::BAKED_MESH::FILE_NOT_SUCCESFULLY_WRITTEN" << std::endl;
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporary_path, path, error);
+    if (error) {
+        std::cerr << "ERROR::BAKED_MESH::FILE_NOT_SUCCESFULLY_WRITTEN" << std::endl;
+        std::filesystem::remove(temporary_path, error);
+        return false;
+    }
+    return true;
+}
+
+VertexPacking BakedMesh::GetVertexPacking() const {
+    return static_cast<VertexPacking>(header.vertex_packing);
+}
+
+GLenum BakedMesh::GetIndexType() const {
+    return header.index_type;
+}
+
+size_t BakedMesh::GetVertexCount() const {
+    return header.cnt_vertexes;
+}
+
+size_t BakedMesh::GetIndexCount() const {
+    return header.cnt_indexes;
+}
+
+const void* BakedMesh::GetVertexData() const {
+    return mapped_file.GetData() + header.vertexes_offset;
+}
+
+const void* BakedMesh::GetPositionData() const {
+    return mapped_file.GetData() + header.positions_offset;
+}
+
+const void* BakedMesh::GetIndexData() const {
+    return mapped_file.GetData() + header.indexes_offset;
+}
+
+const std::vector<MeshLod>& BakedMesh::GetLods() const {
+    return lods;
+}
+
+glm::vec3 BakedMesh::GetBoundsMin() const {
+    return glm::vec3(header.bounds_min[0], header.bounds_min[1], header.bounds_min[2]);
+}
+
+glm::vec3 BakedMesh::GetBoundsMax() const {
+    return glm::vec3(header.bounds_max[0], header.bounds_max[1], header.bounds_max[2]);
+}
+
+size_t BakedMesh::GetSize() const {
+    return mapped_file.GetSize();
+}
+
+bool BakedMesh::IsCurrentVersion(const std::filesystem::path& path) {
+    std::ifstream baked_file(path, std::ios::in | std::ios::binary);
+    uint32_t magic = 0;
+    uint16_t version = 0;
+    baked_file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    baked_file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    return baked_file && magic == MAGIC && version == VERSION;
+}
+
+bool BakedMesh::ValidateHeader(const BakedMeshHeader& header, size_t size) {
+    if (header.file_size != size || header.cnt_lods == 0) {
+        return false;
+    }
+    if (header.vertex_packing != static_cast<uint8_t>(VertexPacking::FLOAT) &&
+        header.vertex_packing != static_cast<uint8_t>(VertexPacking::PACKED)) {
+        return false;
+    }
+    if (header.index_type != GL_UNSIGNED_SHORT && header.index_type != GL_UNSIGNED_INT) {
+        return false;
+    }
+    if (header.index_type == GL_UNSIGNED_SHORT && header.cnt_vertexes > std::numeric_limits<GLushort>::max() + uint64_t(1)) {
+        return false;
+    }
+
+    uint64_t index_size = header.index_type == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+    return IsBlobInside(header.attributes_offset, header.cnt_attributes, sizeof(BakedVertexAttribute), alignof(BakedVertexAttribute), size) &&
+           IsBlobInside(header.lods_offset, header.cnt_lods, sizeof(BakedMeshLod), alignof(BakedMeshLod), size) &&
+           IsBlobInside(header.vertexes_offset, header.cnt_vertexes, header.vertex_stride, BLOB_ALIGNMENT, size) &&
+           IsBlobInside(header.positions_offset, header.cnt_vertexes, sizeof(glm::vec3), BLOB_ALIGNMENT, size) &&
+           IsBlobInside(header.indexes_offset, header.cnt_indexes, index_size, BLOB_ALIGNMENT, size);
+}
+
+bool BakedMesh::ValidateVertexFormat(const BakedMeshHeader& header, const char *data) {
+    VertexFormat vertex_format = Mesh::GetVertexFormat(static_cast<VertexPacking>(header.vertex_packing));
+    if (header.vertex_stride != static_cast<uint32_t>(vertex_format.stride)) {
+        return false;
+    }
+
+    // Формат файла должен совпадать с форматом арены, иначе блок вершин нельзя загружать без преобразования
+    size_t idx_attribute = 0;
+    for (const auto &attribute : vertex_format.attributes) {
+        if (attribute.divisor != 0) {
+            continue;
+        }
+        if (idx_attribute >= header.cnt_attributes) {
+            return false;
+        }
+        BakedVertexAttribute baked_attribute;
+        std::memcpy(&baked_attribute, data + header.attributes_offset + idx_attribute++ * sizeof(baked_attribute), sizeof(baked_attribute));
+        if (baked_attribute.location != attribute.location || baked_attribute.size != attribute.size ||
+            baked_attribute.type != attribute.type || baked_attribute.normalized != attribute.normalized ||
+            baked_attribute.offset != attribute.offset) {
+            return false;
+        }
+    }
+    return idx_attribute == header.cnt_attributes;
+}
+
+bool BakedMesh::ValidateIndexes(const BakedMeshHeader& header, const char *data) {
+    // Индексы только проверяются, блок по-прежнему уходит в буфер без копирования
+    const char *index_data = data + header.indexes_offset;
+    size_t max_index = 0;
+    if (header.index_type == GL_UNSIGNED_SHORT) {
+        const auto *indexes = reinterpret_cast<const GLushort*>(index_data);
+        for (size_t idx = 0; idx < header.cnt_indexes; ++idx) {
+            max_index = std::max<size_t>(max_index, indexes[idx]);
+        }
+    } else {
+        const auto *indexes = reinterpret_cast<const GLuint*>(index_data);
+        for (size_t idx = 0; idx < header.cnt_indexes; ++idx) {
+            max_index = std::max<size_t>(max_index, indexes[idx]);
+        }
+    }
+    return header.cnt_indexes == 0 || max_index < header.cnt_vertexes;
+}
+
+bool BakedMesh::IsBlobInside(uint64_t offset, uint64_t count, uint64_t element_size, uint64_t alignment, size_t size) {
+    return element_size != 0 && offset % alignment == 0 && offset <= size && count <= (size - offset) / element_size;
+}
+
+uint64_t BakedMesh::AlignOffset(uint64_t offset, uint64_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+std::filesystem::path BakedMesh::GetCachePath(const std::filesystem::path& source_path) {
+    std::error_code error;
+    std::filesystem::path absolute_path = std::filesystem::absolute(source_path, error);
+    std::string name_source = (error ? source_path : absolute_path).generic_string();
+    uint64_t key = FNV_OFFSET_BASIS;
+    for (unsigned char symbol : name_source) {
+        key ^= symbol;
+        key *= FNV_PRIME;
+    }
+
+    static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+    std::string name_file(16, '0');
+    for (size_t idx = 0; idx < name_file.size(); ++idx) {
+        name_file[name_file.size() - 1 - idx] = HEX_DIGITS[(key >> (4 * idx)) & 0xF];
+    }
+    return std::filesystem::path(std::string(CACHE_DIRECTORY)) /
+           (source_path.stem().string() + "_" + name_file + std::string(EXTENSION));
+}
@@ -0,0 +1,259 @@
+﻿#include "../libs/CommandBuffer.h"
+#include "../libs/StreamBuffer.h"
+#include "../libs/Model.h"
+
+
+void CommandBuffer::Clear() {
+    commands.clear();
+    data.clear();
+}
+
+void CommandBuffer::UseProgram(uint32_t program) {
+    Push(RenderCommandType::USE_PROGRAM, program);
+}
+
+void CommandBuffer::BindTexture(GLuint unit, GLenum target, GLuint texture_id) {
+    Push(RenderCommandType::BIND_TEXTURE, unit, target, texture_id);
+}
+
+void CommandBuffer::CullFace(GLenum mode) {
+    Push(RenderCommandType::CULL_FACE, mode);
+}
+
+void CommandBuffer::UseVertexStream(VertexStream vertex_stream) {
+    Push(RenderCommandType::USE_VERTEX_STREAM, static_cast<uint32_t>(vertex_stream));
+}
+
+void CommandBuffer::SetInt(GLint location, GLint var_val) {
+    Push(RenderCommandType::SET_INT, static_cast<uint32_t>(location), static_cast<uint32_t>(var_val));
+}
+
+void CommandBuffer::SetFloat(GLint location, GLfloat var_val) {
+    Push(RenderCommandType::SET_FLOAT, static_cast<uint32_t>(location), PushData(&var_val, 1));
+}
+
+void CommandBuffer::SetVec3(GLint location, const glm::vec3& var_val) {
+    Push(RenderCommandType::SET_VEC3, static_cast<uint32_t>(location), PushData(glm::value_ptr(var_val), 3));
+}
+
+void CommandBuffer::SetMat4(GLint location, const glm::mat4& var_val) {
+    Push(RenderCommandType::SET_MAT4, static_cast<uint32_t>(location), PushData(glm::value_ptr(var_val), 16));
+}
+
+void CommandBuffer::DrawMesh(uint32_t mesh, uint32_t program, uint32_t lod) {
+    Push(RenderCommandType::DRAW_MESH, mesh, program, static_cast<uint32_t>(data.size()), 0, lod);
+}
+
+void CommandBuffer::AddInstance(const glm::mat4& model) {
+    if (commands.empty() || commands.back().type != RenderCommandType::DRAW_MESH) {
+        std::cerr << "ERROR::COMMAND_BUFFER::INSTANCE_WITHOUT_DRAW" << std::endl;
+        return;
+    }
+    PushData(glm::value_ptr(model), 16);
+    ++commands.back().args[3];
+}
+
+void CommandBuffer::Execute(const std::vector<ShaderPipe>& shader_programs, std::vector<Mesh>& objects,
+                            StreamBuffer& stream_buffer) const {
+    bool multi_draw = GeometryArena::IsMultiDrawIndirectSupported();
+    GeometryArena *batch_arena = nullptr;
+    VertexStream vertex_stream = VertexStream::FULL;
+    auto flush_draws = [&batch_arena, &vertex_stream]() {
+        if (batch_arena) {
+            batch_arena->FlushDraws(vertex_stream);
+        }
+    };
+
+    const ShaderPipe *shader_program = nullptr;
+    std::optional<MaterialHandle> bound_material;
+    for (const auto &command : commands) {
+        // Любая смена состояния завершает накопленный пакет косвенных отрисовок
+        if (command.type != RenderCommandType::DRAW_MESH) {
+            flush_draws();
+        }
+
+        switch (command.type) {
+        case RenderCommandType::USE_PROGRAM:
+            shader_program = &shader_programs[command.args[0]];
+            shader_program->UseShaderPipe();
+            // Параметры материала хранятся в программе, после ее смены материал привязывается заново
+            bound_material.reset();
+            break;
+        case RenderCommandType::BIND_TEXTURE:
+            GLState::BindTexture(command.args[0], command.args[1], command.args[2]);
+            break;
+        case RenderCommandType::CULL_FACE:
+            GLState::CullFace(command.args[0]);
+            break;
+        case RenderCommandType::USE_VERTEX_STREAM:
+            vertex_stream = static_cast<VertexStream>(command.args[0]);
+            break;
+        case RenderCommandType::SET_INT:
+            shader_program->SetInt(static_cast<GLint>(command.args[0]), static_cast<GLint>(command.args[1]));
+            break;
+        case RenderCommandType::SET_FLOAT:
+            shader_program->SetFloat(static_cast<GLint>(command.args[0]), data[command.args[1]]);
+            break;
+        case RenderCommandType::SET_VEC3:
+            shader_program->SetVec3(static_cast<GLint>(command.args[0]), glm::make_vec3(&data[command.args[1]]));
+            break;
+        case RenderCommandType::SET_MAT4:
+            shader_program->SetMat4(static_cast<GLint>(command.args[0]), glm::make_mat4(&data[command.args[1]]));
+            break;
+        case RenderCommandType::DRAW_MESH: {
+            if (command.args[3] == 0) {
+                break;
+            }
+            const Mesh &object = objects[command.args[0]];
+            const ShaderPipe &draw_program = shader_programs[command.args[1]];
+            GLsizeiptr instance_size = command.args[3] * sizeof(glm::mat4);
+
+            // Материал привязывается один раз на всю серию отрисовок с ним
+            if (bound_material != object.GetMaterial()) {
+                flush_draws();
+                object.BindMaterial(draw_program);
+                bound_material = object.GetMaterial();
+            }
+
+            if (!multi_draw) {
+                GLintptr instance_offset = stream_buffer.Write(&data[command.args[2]], instance_size, sizeof(glm::mat4));
+                object.DrawMesh(*stream_buffer.GetStreamBufferID(), instance_offset, static_cast<GLsizei>(command.args[3]),
+                                vertex_stream, command.args[4]);
+                break;
+            }
+
+            // Меши с 16- и 32-битными индексами лежат в разных аренах и не попадают в один пакет
+            GeometryArena &geometry_arena = object.GetArena();
+            if (&geometry_arena != batch_arena || !stream_buffer.HasSpace(instance_size, sizeof(glm::mat4))) {
+                flush_draws();
+                batch_arena = &geometry_arena;
+            }
+
+            GLintptr instance_offset = stream_buffer.Write(&data[command.args[2]], instance_size, sizeof(glm::mat4));
+            if (geometry_arena.IsQueueEmpty()) {
+                GLState::BindVertexArray(geometry_arena.GetVertexArray(vertex_stream));
+                FigurePosition::BindInstanceAttribute(*stream_buffer.GetStreamBufferID(), 0);
+            }
+            object.QueueMesh(static_cast<GLsizei>(command.args[3]), static_cast<GLuint>(instance_offset / sizeof(glm::mat4)),
+                             command.args[4]);
+            break;
+        }
+        default:
+            std::cerr << "ERROR::COMMAND_BUFFER::UNKNOWN_COMMAND" << std::endl;
+            break;
+        }
+    }
+    flush_draws();
+}
+
+size_t CommandBuffer::GetCommandCount() const {
+    return commands.size();
+}
+
+void CommandBuffer::Push(RenderCommandType type, uint32_t arg_0, uint32_t arg_1, uint32_t arg_2, uint32_t arg_3, uint32_t arg_4) {
+    commands.push_back(RenderCommand{ type, { arg_0, arg_1, arg_2, arg_3, arg_4 } });
+}
+
+uint32_t CommandBuffer::PushData(const GLfloat *values, size_t cnt_values) {
+    uint32_t offset = static_cast<uint32_t>(data.size());
+    data.insert(data.end(), values, values + cnt_values);
+    return offset;
+}
+
+
+CommandRecorder::CommandRecorder(size_t cnt_threads)
+    : buffers(std::max<size_t>(cnt_threads, 1)) {
+    for (size_t idx = 1; idx < buffers.size(); ++idx) {
+        workers.emplace_back(&CommandRecorder::WorkerLoop, this);
+    }
+}
+
+CommandRecorder::~CommandRecorder() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    start_condition.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+void CommandRecorder::Record(size_t cnt_record_items, const RecordFunction& record_function) {
+    size_t cnt_record_chunks = (cnt_record_items + MIN_ITEMS_PER_CHUNK - 1) / MIN_ITEMS_PER_CHUNK;
+    cnt_record_chunks = std::clamp<size_t>(cnt_record_chunks, 1, buffers.size());
+
+    if (cnt_record_chunks == 1 || workers.empty()) {
+        for (size_t idx = 1; idx < buffers.size(); ++idx) {
+            buffers[idx].Clear();
+        }
+        buffers[0].Clear();
+        record_function(0, cnt_record_items, buffers[0]);
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done_condition.wait(lock, [this]() { return cnt_busy == 0; });
+        for (auto &buffer : buffers) {
+            buffer.Clear();
+        }
+        record = &record_function;
+        cnt_items = cnt_record_items;
+        cnt_chunks = cnt_record_chunks;
+        cnt_done = 0;
+        next_chunk = 0;
+        ++generation;
+    }
+    start_condition.notify_all();
+
+    RecordChunks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done_condition.wait(lock, [this]() { return cnt_done == cnt_chunks; });
+    record = nullptr;
+}
+
+void CommandRecorder::Execute(const std::vector<ShaderPipe>& shader_programs, std::vector<Mesh>& objects,
+                              StreamBuffer& stream_buffer) const {
+    for (const auto &buffer : buffers) {
+        buffer.Execute(shader_programs, objects, stream_buffer);
+    }
+}
+
+void CommandRecorder::WorkerLoop() {
+    uint64_t worker_generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            start_condition.wait(lock, [this, worker_generation]() { return stopping || generation != worker_generation; });
+            if (stopping) {
+                return;
+            }
+            worker_generation = generation;
+            ++cnt_busy;
+        }
+
+        RecordChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --cnt_busy;
+        }
+        done_condition.notify_all();
+    }
+}
+
+void CommandRecorder::RecordChunks() {
+    size_t chunk;
+    while ((chunk = next_chunk.fetch_add(1)) < cnt_chunks) {
+        size_t begin = cnt_items * chunk / cnt_chunks;
+        size_t end = cnt_items * (chunk + 1) / cnt_chunks;
+        (*record)(begin, end, buffers[chunk]);
+
+        if (cnt_done.fetch_add(1) + 1 == cnt_chunks) {
+            std::lock_guard<std::mutex> lock(mutex);
+            done_condition.notify_all();
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#include "../libs/GLResource.h"
+#include "../libs/GLState.h"
+
+
+std::array<GLResourceStats, static_cast<size_t>(GLResourceType::COUNT)> GLResourceRegistry::stats;
+bool GLResourceRegistry::context_alive = true;
+
+GLuint GLResourceRegistry::Generate(GLResourceType type) {
+    GLuint id = 0;
+    switch (type) {
+    case GLResourceType::BUFFER:
+        glGenBuffers(1, &id);
+        break;
+    case GLResourceType::TEXTURE:
+        glGenTextures(1, &id);
+        break;
+    case GLResourceType::VERTEX_ARRAY:
+        glGenVertexArrays(1, &id);
+        break;
+    case GLResourceType::PROGRAM:
+        id = glCreateProgram();
+        break;
+    case GLResourceType::FRAMEBUFFER:
+        glGenFramebuffers(1, &id);
+        break;
+    case GLResourceType::SAMPLER:
+        glGenSamplers(1, &id);
+        break;
+    case GLResourceType::QUERY:
+        glGenQueries(1, &id);
+        break;
+    default:
+        std::cerr << "ERROR::GL_RESOURCE::UNKNOWN_TYPE" << std::endl;
+        return 0;
+    }
+    Track(type);
+    return id;
+}
+
+void GLResourceRegistry::Track(GLResourceType type) {
+    auto &type_stats = stats[static_cast<size_t>(type)];
+    ++type_stats.live;
+    ++type_stats.created;
+}
+
+void GLResourceRegistry::Delete(GLResourceType type, GLuint id, GLsizeiptr size) {
+    auto &type_stats = stats[static_cast<size_t>(type)];
+    --type_stats.live;
+    type_stats.bytes -= size;
+
+    if (!context_alive) {
+        return;
+    }
+
+    switch (type) {
+    case GLResourceType::BUFFER:
+        glDeleteBuffers(1, &id);
+        break;
+    case GLResourceType::TEXTURE:
+        glDeleteTextures(1, &id);
+        break;
+    case GLResourceType::VERTEX_ARRAY:
+        glDeleteVertexArrays(1, &id);
+        break;
+    case GLResourceType::PROGRAM:
+        glDeleteProgram(id);
+        break;
+    case GLResourceType::FRAMEBUFFER:
+        glDeleteFramebuffers(1, &id);
+        break;
+    case GLResourceType::SAMPLER:
+        glDeleteSamplers(1, &id);
+        break;
+    case GLResourceType::QUERY:
+        glDeleteQueries(1, &id);
+        break;
+    default:
+        std::cerr << "ERROR::GL_RESOURCE::UNKNOWN_TYPE" << std::endl;
+        break;
+    }
+
+    if (type == GLResourceType::TEXTURE || type == GLResourceType::VERTEX_ARRAY || type == GLResourceType::PROGRAM) {
+        GLState::Invalidate();
+    }
+}
+
+void GLResourceRegistry::Resize(GLResourceType type, GLsizeiptr size, GLsizeiptr new_size) {
+    stats[static_cast<size_t>(type)].bytes += new_size - size;
+}
+
+void GLResourceRegistry::ReleaseContext() {
+    context_alive = false;
+}
+
+bool GLResourceRegistry::IsContextAlive() {
+    return context_alive;
+}
+
+const GLResourceStats& GLResourceRegistry::GetStats(GLResourceType type) {
+    return stats[static_cast<size_t>(type)];
+}
+
+void GLResourceRegistry::PrintStats() {
+    for (size_t idx = 0; idx < stats.size(); ++idx) {
+        const auto &type_stats = stats[idx];
+        std::cout << "GL_RESOURCES::" << GetTypeName(static_cast<GLResourceType>(idx))
+                  << " LIVE " << type_stats.live << " (" << type_stats.bytes / 1024 << " KB), "
+                  << "CREATED " << type_stats.created << std::endl;
+    }
+}
+
+std::string_view GLResourceRegistry::GetTypeName(GLResourceType type) {
+    switch (type) {
+    case GLResourceType::BUFFER:
+        return "BUFFER";
+    case GLResourceType::TEXTURE:
+        return "TEXTURE";
+    case GLResourceType::VERTEX_ARRAY:
+        return "VERTEX_ARRAY";
+    case GLResourceType::PROGRAM:
+        return "PROGRAM";
+    case GLResourceType::FRAMEBUFFER:
+        return "FRAMEBUFFER";
+    case GLResourceType::SAMPLER:
+        return "SAMPLER";
+    case GLResourceType::QUERY:
+        return "QUERY";
+    default:
+        return "UNKNOWN";
+    }
+}
@@ -0,0 +1,89 @@
+#include "../libs/GLState.h"
+
+
+std::optional<GLuint> GLState::program;
+std::optional<GLuint> GLState::vertex_array;
+std::optional<GLuint> GLState::active_texture;
+std::optional<GLenum> GLState::cull_face;
+std::array<std::optional<GLuint>, GLState::MAX_TEXTURE_UNITS> GLState::textures_2d;
+std::array<std::optional<GLuint>, GLState::MAX_TEXTURE_UNITS> GLState::textures_cube;
+GLStateStats GLState::stats;
+
+void GLState::UseProgram(GLuint program_id) {
+    if (IsStateChanged(program, program_id)) {
+        glUseProgram(program_id);
+    }
+}
+
+void GLState::BindVertexArray(GLuint vertex_array_id) {
+    if (IsStateChanged(vertex_array, vertex_array_id)) {
+        glBindVertexArray(vertex_array_id);
+    }
+}
+
+void GLState::ActiveTexture(GLuint unit) {
+    if (IsStateChanged(active_texture, unit)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+}
+
+void GLState::BindTexture(GLuint unit, GLenum target, GLuint texture_id) {
+    auto *binding = GetTextureBinding(unit, target);
+    if (!binding) {
+        ActiveTexture(unit);
+        glBindTexture(target, texture_id);
+        ++stats.issued;
+        return;
+    }
+
+    if (IsStateChanged(*binding, texture_id)) {
+        ActiveTexture(unit);
+        glBindTexture(target, texture_id);
+    }
+}
+
+void GLState::CullFace(GLenum mode) {
+    if (IsStateChanged(cull_face, mode)) {
+        glCullFace(mode);
+    }
+}
+
+void GLState::Invalidate() {
+    program.reset();
+    vertex_array.reset();
+    active_texture.reset();
+    cull_face.reset();
+    textures_2d.fill(std::nullopt);
+    textures_cube.fill(std::nullopt);
+}
+
+const GLStateStats& GLState::GetStats() {
+    return stats;
+}
+
+void GLState::ResetStats() {
+    stats = GLStateStats();
+}
+
+template <typename Type>
+bool GLState::IsStateChanged(std::optional<Type>& state, Type value) {
+    if (state == value) {
+        ++stats.elided;
+        return false;
+    }
+    state = value;
+    ++stats.issued;
+    return true;
+}
+
+std::optional<GLuint>* GLState::GetTextureBinding(GLuint unit, GLenum target) {
+    if (unit >= MAX_TEXTURE_UNITS) {
+        return nullptr;
+    }
+    if (target == GL_TEXTURE_2D) {
+        return &textures_2d[unit];
+    } else if (target == GL_TEXTURE_CUBE_MAP) {
+        return &textures_cube[unit];
+    }
+    return nullptr;
+}
@@ -0,0 +1,277 @@
+#include "../libs/GeometryArena.h"
+
+
+GLuint GeometryArena::cnt_meshes = 0;
+GeometryDrawStats GeometryArena::draw_stats;
+
+GeometryArena::GeometryArena(VertexFormat vertex_format, GLenum index_type)
+    : vertex_format(std::move(vertex_format)), index_type(index_type), index_size(GetIndexSize(index_type)) {}
+
+GeometryRange GeometryArena::Allocate(const void *vertexes, size_t cnt_new_vertexes, const std::vector<GLuint>& indexes) {
+    if (index_type == GL_UNSIGNED_SHORT) {
+        std::vector<GLushort> short_indexes(indexes.begin(), indexes.end());
+        return Allocate(vertexes, cnt_new_vertexes, std::data(short_indexes), short_indexes.size());
+    }
+    return Allocate(vertexes, cnt_new_vertexes, std::data(indexes), indexes.size());
+}
+
+GeometryRange GeometryArena::Allocate(const void *vertexes, size_t cnt_new_vertexes, const void *indexes, size_t cnt_new_indexes,
+                                      const void *positions) {
+    if (index_type == GL_UNSIGNED_SHORT && cnt_new_vertexes > std::numeric_limits<GLushort>::max() + size_t(1)) {
+        std::cerr << "ERROR::GEOMETRY_ARENA::INDEX_TYPE_TOO_SMALL" << std::endl;
+        return GeometryRange();
+    }
+
+    if (!vertex_array) {
+        vertex_array = GLVertexArray::Create();
+        if (GetPositionOffset()) {
+            position_vertex_array = GLVertexArray::Create();
+        }
+    }
+
+    GeometryBlock block;
+    block.cnt_vertexes = static_cast<GLsizeiptr>(cnt_new_vertexes);
+    block.cnt_indexes = static_cast<GLsizeiptr>(cnt_new_indexes);
+    block.first_vertex = TakeFreeBlock(free_vertexes, block.cnt_vertexes).value_or(cnt_vertexes);
+    block.first_index = TakeFreeBlock(free_indexes, block.cnt_indexes).value_or(cnt_indexes);
+    GLsizeiptr new_cnt_vertexes = std::max(cnt_vertexes, block.first_vertex + block.cnt_vertexes);
+    GLsizeiptr new_cnt_indexes = std::max(cnt_indexes, block.first_index + block.cnt_indexes);
+
+    GLsizeiptr new_vertex_capacity = std::max(vertex_capacity, INITIAL_VERTEX_CAPACITY);
+    while (new_cnt_vertexes > new_vertex_capacity) {
+        new_vertex_capacity *= 2;
+    }
+    GLsizeiptr new_index_capacity = std::max(index_capacity, INITIAL_INDEX_CAPACITY);
+    while (new_cnt_indexes > new_index_capacity) {
+        new_index_capacity *= 2;
+    }
+    if (new_vertex_capacity != vertex_capacity || new_index_capacity != index_capacity) {
+        Reserve(new_vertex_capacity, new_index_capacity);
+    }
+
+    GeometryRange range;
+    range.base_vertex = static_cast<GLint>(block.first_vertex);
+    range.first_index = static_cast<GLuint>(block.first_index);
+    range.cnt_indexes = static_cast<GLsizei>(cnt_new_indexes);
+    range.mesh_id = ++cnt_meshes;
+    blocks[range.mesh_id] = block;
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer.Get());
+    glBufferSubData(GL_ARRAY_BUFFER, block.first_vertex * vertex_format.stride, cnt_new_vertexes * vertex_format.stride, vertexes);
+    if (auto position_offset = GetPositionOffset()) {
+        std::vector<GLubyte> extracted_positions;
+        if (!positions) {
+            extracted_positions.resize(cnt_new_vertexes * POSITION_STRIDE);
+            const auto *vertex_bytes = static_cast<const GLubyte*>(vertexes) + *position_offset;
+            for (size_t idx = 0; idx < cnt_new_vertexes; ++idx) {
+                std::memcpy(&extracted_positions[idx * POSITION_STRIDE], vertex_bytes + idx * vertex_format.stride, POSITION_STRIDE);
+            }
+            positions = std::data(extracted_positions);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, position_buffer.Get());
+        glBufferSubData(GL_ARRAY_BUFFER, block.first_vertex * POSITION_STRIDE, cnt_new_vertexes * POSITION_STRIDE, positions);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, index_buffer.Get());
+    glBufferSubData(GL_COPY_WRITE_BUFFER, block.first_index * index_size, cnt_new_indexes * index_size, indexes);
+
+    cnt_vertexes = new_cnt_vertexes;
+    cnt_indexes = new_cnt_indexes;
+    return range;
+}
+
+void GeometryArena::Free(const GeometryRange& range) {
+    auto block = blocks.find(range.mesh_id);
+    if (block == blocks.end()) {
+        return;
+    }
+    ReturnFreeBlock(free_vertexes, block->second.first_vertex, block->second.cnt_vertexes, cnt_vertexes);
+    ReturnFreeBlock(free_indexes, block->second.first_index, block->second.cnt_indexes, cnt_indexes);
+    blocks.erase(block);
+}
+
+GLuint GeometryArena::GetVertexArray(VertexStream vertex_stream) const {
+    return vertex_stream == VertexStream::POSITION && position_vertex_array ? position_vertex_array.Get() : vertex_array.Get();
+}
+
+GLenum GeometryArena::GetIndexType() const {
+    return index_type;
+}
+
+void GeometryArena::DrawRange(const GeometryRange& range, GLsizei cnt_instances, VertexStream vertex_stream) const {
+    GLState::BindVertexArray(GetVertexArray(vertex_stream));
+    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, range.cnt_indexes, index_type,
+                                      reinterpret_cast<void*>(range.first_index * index_size),
+                                      cnt_instances, range.base_vertex);
+    draw_stats.indexes += static_cast<size_t>(range.cnt_indexes) * cnt_instances;
+}
+
+void GeometryArena::QueueDraw(const GeometryRange& range, GLsizei cnt_instances, GLuint base_instance) {
+    queued_draws.push_back(DrawElementsIndirectCommand{ static_cast<GLuint>(range.cnt_indexes), static_cast<GLuint>(cnt_instances),
+                                                        range.first_index, range.base_vertex, base_instance });
+}
+
+void GeometryArena::FlushDraws(VertexStream vertex_stream) {
+    if (queued_draws.empty()) {
+        return;
+    }
+
+    GLsizeiptr size = queued_draws.size() * sizeof(DrawElementsIndirectCommand);
+    if (!indirect_buffer) {
+        indirect_buffer = GLBuffer::Create();
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirect_buffer.Get());
+    if (size > indirect_capacity) {
+        indirect_capacity = std::max(size, indirect_capacity * 2);
+        indirect_buffer.SetSize(indirect_capacity);
+    }
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, indirect_capacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, size, std::data(queued_draws));
+
+    GLState::BindVertexArray(GetVertexArray(vertex_stream));
+    glMultiDrawElementsIndirect(GL_TRIANGLES, index_type, nullptr, static_cast<GLsizei>(queued_draws.size()), 0);
+    for (const auto &draw : queued_draws) {
+        draw_stats.indexes += static_cast<size_t>(draw.count) * draw.instance_count;
+    }
+    queued_draws.clear();
+}
+
+bool GeometryArena::IsQueueEmpty() const {
+    return queued_draws.empty();
+}
+
+bool GeometryArena::IsMultiDrawIndirectSupported() {
+    return GLAD_GL_VERSION_4_3 || (GLAD_GL_ARB_multi_draw_indirect && GLAD_GL_ARB_base_instance);
+}
+
+GLsizeiptr GeometryArena::GetIndexSize(GLenum index_type) {
+    switch (index_type) {
+    case GL_UNSIGNED_BYTE:
+        return sizeof(GLubyte);
+    case GL_UNSIGNED_SHORT:
+        return sizeof(GLushort);
+    default:
+        return sizeof(GLuint);
+    }
+}
+
+const GeometryDrawStats& GeometryArena::GetDrawStats() {
+    return draw_stats;
+}
+
+void GeometryArena::ResetDrawStats() {
+    draw_stats = GeometryDrawStats();
+}
+
+void GeometryArena::Reserve(GLsizeiptr new_vertex_capacity, GLsizeiptr new_index_capacity) {
+    vertex_buffer = ResizeBuffer(vertex_buffer, vertex_capacity * vertex_format.stride,
+                                 new_vertex_capacity * vertex_format.stride);
+    index_buffer = ResizeBuffer(index_buffer, index_capacity * index_size, new_index_capacity * index_size);
+    if (GetPositionOffset()) {
+        position_buffer = ResizeBuffer(position_buffer, vertex_capacity * POSITION_STRIDE, new_vertex_capacity * POSITION_STRIDE);
+    }
+    vertex_capacity = new_vertex_capacity;
+    index_capacity = new_index_capacity;
+
+    SetVertexFormat();
+}
+
+void GeometryArena::SetVertexFormat() const {
+    GLState::BindVertexArray(vertex_array.Get());
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer.Get());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer.Get());
+
+    for (const auto &attribute : vertex_format.attributes) {
+        glEnableVertexAttribArray(attribute.location);
+        if (attribute.divisor == 0) {
+            glVertexAttribPointer(attribute.location, attribute.size, attribute.type, attribute.normalized,
+                                  vertex_format.stride, reinterpret_cast<void*>(attribute.offset));
+        } else {
+            glVertexAttribDivisor(attribute.location, attribute.divisor);
+        }
+    }
+
+    if (GetPositionOffset()) {
+        GLState::BindVertexArray(position_vertex_array.Get());
+        glBindBuffer(GL_ARRAY_BUFFER, position_buffer.Get());
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer.Get());
+
+        glEnableVertexAttribArray(POSITION_LOCATION);
+        glVertexAttribPointer(POSITION_LOCATION, 3, GL_FLOAT, GL_FALSE, POSITION_STRIDE, nullptr);
+        for (const auto &attribute : vertex_format.attributes) {
+            if (attribute.divisor != 0) {
+                glEnableVertexAttribArray(attribute.location);
+                glVertexAttribDivisor(attribute.location, attribute.divisor);
+            }
+        }
+    }
+
+    GLState::BindVertexArray(0);
+}
+
+std::optional<size_t> GeometryArena::GetPositionOffset() const {
+    for (const auto &attribute : vertex_format.attributes) {
+        if (attribute.location == POSITION_LOCATION && attribute.size == 3 && attribute.type == GL_FLOAT && attribute.divisor == 0) {
+            return attribute.offset;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<GLsizeiptr> GeometryArena::TakeFreeBlock(std::map<GLsizeiptr, GLsizeiptr>& free_blocks, GLsizeiptr size) {
+    if (size == 0) {
+        return std::nullopt;
+    }
+    for (auto free_block = free_blocks.begin(); free_block != free_blocks.end(); ++free_block) {
+        if (free_block->second < size) {
+            continue;
+        }
+        GLsizeiptr offset = free_block->first;
+        GLsizeiptr rest = free_block->second - size;
+        free_blocks.erase(free_block);
+        if (rest > 0) {
+            free_blocks.emplace(offset + size, rest);
+        }
+        return offset;
+    }
+    return std::nullopt;
+}
+
+// Блок сливается с соседями, а если оказался в хвосте - просто укорачивает занятую часть буфера
+void GeometryArena::ReturnFreeBlock(std::map<GLsizeiptr, GLsizeiptr>& free_blocks, GLsizeiptr offset, GLsizeiptr size, GLsizeiptr& end) {
+    if (size == 0) {
+        return;
+    }
+    auto next = free_blocks.lower_bound(offset);
+    if (next != free_blocks.end() && offset + size == next->first) {
+        size += next->second;
+        next = free_blocks.erase(next);
+    }
+    if (next != free_blocks.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            free_blocks.erase(previous);
+        }
+    }
+
+    if (offset + size == end) {
+        end = offset;
+    } else {
+        free_blocks.emplace(offset, size);
+    }
+}
+
+GLBuffer GeometryArena::ResizeBuffer(const GLBuffer& buffer, GLsizeiptr size, GLsizeiptr new_size) {
+    GLBuffer new_buffer = GLBuffer::Create();
+    glBindBuffer(GL_COPY_WRITE_BUFFER, new_buffer.Get());
+    glBufferData(GL_COPY_WRITE_BUFFER, new_size, nullptr, GL_STATIC_DRAW);
+    new_buffer.SetSize(new_size);
+
+    if (buffer) {
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer.Get());
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, size);
+    }
+    return new_buffer;
+}
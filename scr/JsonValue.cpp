@@ -0,0 +1,226 @@
+﻿#include "../libs/JsonValue.h"
+
+
+std::optional<JsonValue> JsonValue::Parse(std::string_view text) {
+    JsonValue value;
+    size_t position = 0;
+    if (!ParseValue(text, position, value, 0)) {
+        return std::nullopt;
+    }
+    SkipWhitespace(text, position);
+    if (position != text.size() && text[position] != '\0') {
+        return std::nullopt;
+    }
+    return value;
+}
+
+JsonType JsonValue::GetType() const {
+    return type;
+}
+
+bool JsonValue::IsNull() const {
+    return type == JsonType::NUL;
+}
+
+bool JsonValue::Contains(std::string_view key) const {
+    return !(*this)[key].IsNull();
+}
+
+size_t JsonValue::GetSize() const {
+    return type == JsonType::OBJECT ? object.size() : array.size();
+}
+
+double JsonValue::GetNumber(double default_value) const {
+    return type == JsonType::NUMBER ? number : default_value;
+}
+
+bool JsonValue::GetBoolean(bool default_value) const {
+    return type == JsonType::BOOLEAN ? boolean : default_value;
+}
+
+const std::string& JsonValue::GetString() const {
+    return string;
+}
+
+const std::vector<JsonValue>& JsonValue::GetArray() const {
+    return array;
+}
+
+const JsonValue& JsonValue::operator[](std::string_view key) const {
+    static const JsonValue null_value;
+    for (const auto &[name, value] : object) {
+        if (name == key) {
+            return value;
+        }
+    }
+    return null_value;
+}
+
+const JsonValue& JsonValue::operator[](size_t idx) const {
+    static const JsonValue null_value;
+    return idx < array.size() ? array[idx] : null_value;
+}
+
+bool JsonValue::ParseValue(std::string_view text, size_t& position, JsonValue& value, size_t depth) {
+    SkipWhitespace(text, position);
+    if (position >= text.size() || depth > MAX_DEPTH) {
+        return false;
+    }
+
+    switch (text[position]) {
+    case '{': {
+        value.type = JsonType::OBJECT;
+        SkipWhitespace(text, ++position);
+        if (position < text.size() && text[position] == '}') {
+            ++position;
+            return true;
+        }
+        while (true) {
+            std::string key;
+            SkipWhitespace(text, position);
+            if (!ParseString(text, position, key)) {
+                return false;
+            }
+            SkipWhitespace(text, position);
+            if (position >= text.size() || text[position] != ':') {
+                return false;
+            }
+            ++position;
+            value.object.emplace_back(std::move(key), JsonValue());
+            if (!ParseValue(text, position, value.object.back().second, depth + 1)) {
+                return false;
+            }
+            SkipWhitespace(text, position);
+            if (position < text.size() && text[position] == ',') {
+                ++position;
+                continue;
+            }
+            if (position < text.size() && text[position] == '}') {
+                ++position;
+                return true;
+            }
+            return false;
+        }
+    }
+    case '[': {
+        value.type = JsonType::ARRAY;
+        SkipWhitespace(text, ++position);
+        if (position < text.size() && text[position] == ']') {
+            ++position;
+            return true;
+        }
+        while (true) {
+            value.array.emplace_back();
+            if (!ParseValue(text, position, value.array.back(), depth + 1)) {
+                return false;
+            }
+            SkipWhitespace(text, position);
+            if (position < text.size() && text[position] == ',') {
+                ++position;
+                continue;
+            }
+            if (position < text.size() && text[position] == ']') {
+                ++position;
+                return true;
+            }
+            return false;
+        }
+    }
+    case '"':
+        value.type = JsonType::STRING;
+        return ParseString(text, position, value.string);
+    case 't':
+    case 'f': {
+        std::string_view literal = text[position] == 't' ? "true" : "false";
+        if (text.substr(position, literal.size()) != literal) {
+            return false;
+        }
+        value.type = JsonType::BOOLEAN;
+        value.boolean = text[position] == 't';
+        position += literal.size();
+        return true;
+    }
+    case 'n':
+        if (text.substr(position, 4) != "null") {
+            return false;
+        }
+        position += 4;
+        return true;
+    default:
+        value.type = JsonType::NUMBER;
+        return ParseNumber(text, position, value.number);
+    }
+}
+
+bool JsonValue::ParseString(std::string_view text, size_t& position, std::string& result) {
+    if (position >= text.size() || text[position] != '"') {
+        return false;
+    }
+    ++position;
+
+    while (position < text.size()) {
+        char symbol = text[position++];
+        if (symbol == '"') {
+            return true;
+        }
+        if (symbol != '\\') {
+            result.push_back(symbol);
+            continue;
+        }
+        if (position >= text.size()) {
+            return false;
+        }
+
+        char escape = text[position++];
+        switch (escape) {
+        case 'b': result.push_back('\b'); break;
+        case 'f': result.push_back('\f'); break;
+        case 'n': result.push_back('\n'); break;
+        case 'r': result.push_back('\r'); break;
+        case 't': result.push_back('\t'); break;
+        case 'u': {
+            uint32_t code_point = 0;
+            if (position + 4 > text.size() ||
+                std::from_chars(text.data() + position, text.data() + position + 4, code_point, 16).ptr != text.data() + position + 4) {
+                return false;
+            }
+            position += 4;
+            AppendUtf8(result, code_point);
+            break;
+        }
+        default:
+            result.push_back(escape);
+            break;
+        }
+    }
+    return false;
+}
+
+bool JsonValue::ParseNumber(std::string_view text, size_t& position, double& result) {
+    auto [end, error] = std::from_chars(text.data() + position, text.data() + text.size(), result);
+    if (error != std::errc()) {
+        return false;
+    }
+    position = end - text.data();
+    return true;
+}
+
+void JsonValue::SkipWhitespace(std::string_view text, size_t& position) {
+    while (position < text.size() &&
+           (text[position] == ' ' || text[position] == '\t' || text[position] == '\n' || text[position] == '\r')) {
+        ++position;
+    }
+}
+
+void JsonValue::AppendUtf8(std::string& result, uint32_t code_point) {
+    if (code_point < 0x80) {
+        result.push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        result.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        result.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        result.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        result.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        result.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
@@ -0,0 +1,105 @@
+﻿#include "../libs/MappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+#ifdef _WIN32
+    HANDLE file_handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                     FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        std::cerr << "ERROR::MAPPED_FILE::FILE_NOT_SUCCESFULLY_READ" << std::endl;
+        return;
+    }
+
+    LARGE_INTEGER file_size;
+    if (GetFileSizeEx(file_handle, &file_size) && file_size.QuadPart > 0) {
+        HANDLE mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_handle) {
+            data = static_cast<const char*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle(mapping_handle);
+        }
+        if (data) {
+            size = static_cast<size_t>(file_size.QuadPart);
+        }
+    }
+    CloseHandle(file_handle);
+#else
+    int file_descriptor = open(path.c_str(), O_RDONLY);
+    if (file_descriptor < 0) {
+        std::cerr << "ERROR::MAPPED_FILE::FILE_NOT_SUCCESFULLY_READ" << std::endl;
+        return;
+    }
+
+    struct stat file_stat;
+    if (fstat(file_descriptor, &file_stat) == 0 && file_stat.st_size > 0) {
+        void *mapping = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+        if (mapping != MAP_FAILED) {
+            madvise(mapping, static_cast<size_t>(file_stat.st_size), MADV_SEQUENTIAL);
+            data = static_cast<const char*>(mapping);
+            size = static_cast<size_t>(file_stat.st_size);
+        }
+    }
+    close(file_descriptor);
+#endif
+
+    if (!data) {
+        std::cerr << "ERROR::MAPPED_FILE::FILE_NOT_MAPPED" << std::endl;
+    }
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+    }
+    return *this;
+}
+
+bool MappedFile::IsOpen() const {
+    return data != nullptr;
+}
+
+const char* MappedFile::GetData() const {
+    return data;
+}
+
+size_t MappedFile::GetSize() const {
+    return size;
+}
+
+std::string_view MappedFile::GetView() const {
+    return std::string_view(data, size);
+}
+
+void MappedFile::Close() {
+    if (!data) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+#else
+    munmap(const_cast<char*>(data), size);
+#endif
+    data = nullptr;
+    size = 0;
+}
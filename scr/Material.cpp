@@ -0,0 +1,111 @@
+#include "../libs/Material.h"
+
+
+Material::Material(std::vector<Texture2D>&& textures)
+    : textures(std::move(textures)) {
+    int cnt_diffuse = 0;
+    int cnt_specular = 0;
+    int cnt_normal = 0;
+    int cnt_depth = 0;
+
+    texture_names.reserve(this->textures.size());
+    texture_units.reserve(this->textures.size());
+    for (const auto &texture : this->textures) {
+        std::string_view type_texture;
+        int layer = 0;
+
+        if (texture.GetType() == Texture2D::DIFFUSE_MAP) {
+            type_texture = Texture2D::DIFFUSE_MAP;
+            layer = cnt_diffuse++;
+        } else if (texture.GetType() == Texture2D::SPECULAR_MAP) {
+            type_texture = Texture2D::SPECULAR_MAP;
+            layer = cnt_specular++;
+        } else if (texture.GetType() == Texture2D::NORMAL_MAP) {
+            type_texture = Texture2D::NORMAL_MAP;
+            layer = cnt_normal++;
+        } else {
+            type_texture = Texture2D::DEPTH_MAP;
+            layer = cnt_depth++;
+        }
+
+        std::stringstream name_texture;
+        name_texture << type_texture << "[" << layer << "]";
+        texture_names.emplace_back(name_texture.str());
+
+        auto unit = TextureUnits::GetTextureUnit(type_texture, layer);
+        if (!unit) {
+            std::cerr << "ERROR::MATERIAL::TEXTURE_UNIT_OUT_OF_RANGE " << name_texture.str() << std::endl;
+        }
+        texture_units.push_back(unit.value_or(0));
+    }
+}
+
+const std::vector<size_t>& Material::BindShaderPipe(const ShaderPipe &shader_program) {
+    auto &bindings = texture_bindings[*shader_program.GetShaderPipeID()];
+    bindings.clear();
+
+    for (size_t idx = 0; idx < textures.size(); ++idx) {
+        if (shader_program.HasParameter(texture_names[idx].texture)) {
+            bindings.push_back(idx);
+        }
+    }
+    return bindings;
+}
+
+void Material::UseMaterial(const ShaderPipe &shader_program) {
+    auto bindings = texture_bindings.find(*shader_program.GetShaderPipeID());
+    const auto &texture_idxs = bindings != texture_bindings.end() ? bindings->second : BindShaderPipe(shader_program);
+
+    for (size_t idx : texture_idxs) {
+        textures[idx].UseTexture(shader_program, texture_names[idx], texture_units[idx]);
+    }
+}
+
+const std::vector<Texture2D>& Material::GetTextures() const {
+    return textures;
+}
+
+MaterialHandle Material::CreateMaterial(std::vector<Texture2D>&& textures) {
+    auto &materials = GetMaterials();
+    auto &free_handles = GetFreeHandles();
+    if (!free_handles.empty()) {
+        MaterialHandle handle = free_handles.back();
+        free_handles.pop_back();
+        materials[handle].material.emplace(std::move(textures));
+        return handle;
+    }
+    materials.emplace_back().material.emplace(std::move(textures));
+    return static_cast<MaterialHandle>(materials.size() - 1);
+}
+
+std::shared_ptr<Material> Material::AcquireMaterial(MaterialHandle handle) {
+    auto &slot = GetMaterials()[handle];
+    if (!slot.material) {
+        std::cerr << "ERROR::MATERIAL::RELEASED_MATERIAL " << handle << std::endl;
+        return nullptr;
+    }
+    ++slot.cnt_references;
+    return std::shared_ptr<Material>(&*slot.material, [handle](Material*) { ReleaseMaterial(handle); });
+}
+
+Material& Material::GetMaterial(MaterialHandle handle) {
+    return *GetMaterials()[handle].material;
+}
+
+void Material::ReleaseMaterial(MaterialHandle handle) {
+    auto &slot = GetMaterials()[handle];
+    if (--slot.cnt_references == 0) {
+        slot.material.reset();
+        GetFreeHandles().push_back(handle);
+    }
+}
+
+std::deque<Material::MaterialSlot>& Material::GetMaterials() {
+    static std::deque<MaterialSlot> materials;
+    return materials;
+}
+
+std::vector<MaterialHandle>& Material::GetFreeHandles() {
+    static std::vector<MaterialHandle> free_handles;
+    return free_handles;
+}
@@ -0,0 +1,712 @@
+﻿#include "../libs/MeshImporter.h"
+
+
+MeshImportStats MeshImporter::stats;
+
+std::optional<MeshData> MeshImporter::LoadMesh(const std::filesystem::path& path) {
+    auto start_time = std::chrono::steady_clock::now();
+
+    MappedFile mapped_file(path);
+    if (!mapped_file.IsOpen()) {
+        return std::nullopt;
+    }
+
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char symbol) { return static_cast<char>(std::tolower(symbol)); });
+
+    std::optional<MeshData> mesh_data;
+    if (extension == ".obj") {
+        mesh_data = LoadObj(mapped_file.GetView());
+    } else if (extension == ".glb") {
+        mesh_data = LoadGlb(mapped_file.GetView());
+    } else {
+        std::cerr << "ERROR::MESH_IMPORTER::UNKNOWN_FORMAT " << extension << std::endl;
+        return std::nullopt;
+    }
+    if (!mesh_data) {
+        return std::nullopt;
+    }
+
+    std::chrono::duration<double, std::milli> load_time = std::chrono::steady_clock::now() - start_time;
+    ++stats.cnt_files;
+    stats.bytes += mapped_file.GetSize();
+    stats.time += load_time;
+
+    double size_mb = mapped_file.GetSize() / (1024.0 * 1024.0);
+    std::cout << "MESH_IMPORTER::LOADED " << path.filename().string() << " " << size_mb << " MB, "
+              << mesh_data->vertexes.size() << " VERTEXES, " << mesh_data->indexes.size() / 3 << " TRIANGLES in "
+              << load_time.count() << " ms (" << size_mb * 1000.0 / std::max(load_time.count(), 1e-3) << " MB/s)" << std::endl;
+
+    MeshOptimizer::OptimizeMesh(*mesh_data);
+    return mesh_data;
+}
+
+std::optional<MeshData> MeshImporter::LoadObj(std::string_view text) {
+    size_t cnt_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    size_t cnt_chunks = std::clamp<size_t>(text.size() / MIN_CHUNK_SIZE, 1, cnt_threads);
+
+    // Границы фрагментов сдвигаются на начало следующей строки
+    std::vector<size_t> bounds(cnt_chunks + 1, text.size());
+    bounds[0] = 0;
+    for (size_t idx = 1; idx < cnt_chunks; ++idx) {
+        size_t line_end = text.find('\n', std::max(text.size() * idx / cnt_chunks, bounds[idx - 1]));
+        bounds[idx] = line_end == std::string_view::npos ? text.size() : line_end + 1;
+    }
+
+    std::vector<ObjChunk> chunks(cnt_chunks);
+    ParallelFor(cnt_chunks, [&](size_t idx) {
+        ParseObjChunk(text.substr(bounds[idx], bounds[idx + 1] - bounds[idx]), chunks[idx]);
+    });
+    if (std::any_of(chunks.begin(), chunks.end(), [](const ObjChunk &chunk) { return !chunk.valid; })) {
+        std::cerr << "ERROR::MESH_IMPORTER::OBJ_SYNTAX_ERROR" << std::endl;
+        return std::nullopt;
+    }
+
+    // Атрибуты фрагментов складываются в общие массивы, отрицательные индексы отсчитываются от начала своего фрагмента
+    std::vector<std::array<size_t, 3>> bases(cnt_chunks);
+    std::array<size_t, 3> totals{ 0, 0, 0 };
+    for (size_t idx = 0; idx < cnt_chunks; ++idx) {
+        bases[idx] = totals;
+        totals[0] += chunks[idx].positions.size();
+        totals[1] += chunks[idx].texture_positions.size();
+        totals[2] += chunks[idx].normals.size();
+    }
+
+    std::vector<glm::vec3> positions(totals[0]);
+    std::vector<glm::vec2> texture_positions(totals[1]);
+    std::vector<glm::vec3> normals(totals[2]);
+    ParallelFor(cnt_chunks, [&](size_t idx) {
+        std::copy(chunks[idx].positions.begin(), chunks[idx].positions.end(), positions.begin() + bases[idx][0]);
+        std::copy(chunks[idx].texture_positions.begin(), chunks[idx].texture_positions.end(), texture_positions.begin() + bases[idx][1]);
+        std::copy(chunks[idx].normals.begin(), chunks[idx].normals.end(), normals.begin() + bases[idx][2]);
+    });
+
+    std::vector<MeshData> chunk_meshes(cnt_chunks);
+    std::vector<uint8_t> built(cnt_chunks, 0);
+    ParallelFor(cnt_chunks, [&](size_t idx) {
+        built[idx] = BuildObjChunk(chunks[idx], positions, texture_positions, normals, bases[idx], chunk_meshes[idx]);
+        chunks[idx] = ObjChunk();
+    });
+    if (std::find(built.begin(), built.end(), 0) != built.end()) {
+        std::cerr << "ERROR::MESH_IMPORTER::OBJ_INDEX_OUT_OF_RANGE" << std::endl;
+        return std::nullopt;
+    }
+
+    MeshData mesh_data = MergeMeshData(chunk_meshes);
+    if (mesh_data.indexes.empty()) {
+        std::cerr << "ERROR::MESH_IMPORTER::EMPTY_MESH" << std::endl;
+        return std::nullopt;
+    }
+
+    ComputeNormals(mesh_data);
+    ComputeTangents(mesh_data);
+    return mesh_data;
+}
+
+std::optional<MeshData> MeshImporter::LoadGlb(std::string_view file) {
+    uint32_t header[3];
+    if (file.size() < sizeof(header)) {
+        std::cerr << "ERROR::MESH_IMPORTER::GLB_INVALID_HEADER" << std::endl;
+        return std::nullopt;
+    }
+    std::memcpy(header, file.data(), sizeof(header));
+    if (header[0] != GLB_MAGIC || header[1] != 2 || header[2] > file.size()) {
+        std::cerr << "ERROR::MESH_IMPORTER::GLB_INVALID_HEADER" << std::endl;
+        return std::nullopt;
+    }
+
+    std::string_view json_chunk;
+    std::string_view binary_chunk;
+    for (size_t offset = sizeof(header); offset + 2 * sizeof(uint32_t) <= header[2];) {
+        uint32_t chunk_header[2];
+        std::memcpy(chunk_header, file.data() + offset, sizeof(chunk_header));
+        offset += sizeof(chunk_header);
+        if (offset + chunk_header[0] > header[2]) {
+            std::cerr << "ERROR::MESH_IMPORTER::GLB_INVALID_CHUNK" << std::endl;
+            return std::nullopt;
+        }
+
+        std::string_view chunk_data = file.substr(offset, chunk_header[0]);
+        if (chunk_header[1] == GLB_CHUNK_JSON && json_chunk.empty()) {
+            json_chunk = chunk_data;
+        } else if (chunk_header[1] == GLB_CHUNK_BIN && binary_chunk.empty()) {
+            binary_chunk = chunk_data;
+        }
+        offset += chunk_header[0];
+    }
+
+    std::optional<JsonValue> document = JsonValue::Parse(json_chunk);
+    if (!document) {
+        std::cerr << "ERROR::MESH_IMPORTER::GLB_INVALID_JSON" << std::endl;
+        return std::nullopt;
+    }
+
+    std::vector<std::pair<const JsonValue*, glm::mat4>> primitives;
+    for (const auto &instance : GetGltfInstances(*document)) {
+        for (const auto &primitive : (*document)["meshes"][instance.mesh]["primitives"].GetArray()) {
+            primitives.emplace_back(&primitive, instance.world);
+        }
+    }
+
+    std::vector<MeshData> primitive_meshes(primitives.size());
+    std::vector<uint8_t> built(primitives.size(), 0);
+    ParallelFor(primitives.size(), [&](size_t idx) {
+        built[idx] = BuildGltfPrimitive(*document, *primitives[idx].first, primitives[idx].second, binary_chunk, primitive_meshes[idx]);
+    });
+    size_t cnt_skipped = std::count(built.begin(), built.end(), 0);
+    if (cnt_skipped > 0) {
+        std::cerr << "ERROR::MESH_IMPORTER::GLB_PRIMITIVES_SKIPPED " << cnt_skipped << std::endl;
+    }
+
+    MeshData mesh_data = MergeMeshData(primitive_meshes);
+    if (mesh_data.indexes.empty()) {
+        std::cerr << "ERROR::MESH_IMPORTER::EMPTY_MESH" << std::endl;
+        return std::nullopt;
+    }
+
+    ComputeNormals(mesh_data);
+    ComputeTangents(mesh_data);
+    return mesh_data;
+}
+
+void MeshImporter::ComputeNormals(MeshData &mesh_data) {
+    auto &[vertexes, indexes] = mesh_data;
+    auto is_missing = [](const Vertex &vertex) { return glm::dot(vertex.normal, vertex.normal) == 0.0f; };
+    if (std::none_of(vertexes.begin(), vertexes.end(), is_missing)) {
+        return;
+    }
+
+    std::vector<glm::vec3> normals(vertexes.size(), glm::vec3(0.0f));
+    for (size_t idx = 0; idx + 2 < indexes.size(); idx += 3) {
+        const glm::vec3 &first = vertexes[indexes[idx]].position;
+        glm::vec3 face_normal = glm::cross(vertexes[indexes[idx + 1]].position - first, vertexes[indexes[idx + 2]].position - first);
+        for (size_t corner = 0; corner < 3; ++corner) {
+            normals[indexes[idx + corner]] += face_normal;
+        }
+    }
+
+    for (size_t idx = 0; idx < vertexes.size(); ++idx) {
+        if (!is_missing(vertexes[idx])) {
+            continue;
+        }
+        GLfloat length = glm::length(normals[idx]);
+        vertexes[idx].normal = length > 0.0f ? normals[idx] / length : glm::vec3(0.0f, 1.0f, 0.0f);
+    }
+}
+
+void MeshImporter::ComputeTangents(MeshData &mesh_data) {
+    auto &[vertexes, indexes] = mesh_data;
+    auto is_missing = [](const Vertex &vertex) { return glm::dot(glm::vec3(vertex.tangent), glm::vec3(vertex.tangent)) == 0.0f; };
+    if (std::none_of(vertexes.begin(), vertexes.end(), is_missing)) {
+        return;
+    }
+
+    std::vector<glm::vec3> tangents(vertexes.size(), glm::vec3(0.0f));
+    std::vector<glm::vec3> bitangents(vertexes.size(), glm::vec3(0.0f));
+    for (size_t idx = 0; idx + 2 < indexes.size(); idx += 3) {
+        const Vertex &first = vertexes[indexes[idx]];
+        const Vertex &second = vertexes[indexes[idx + 1]];
+        const Vertex &third = vertexes[indexes[idx + 2]];
+
+        glm::vec3 side_first = second.position - first.position;
+        glm::vec3 side_second = third.position - first.position;
+        glm::vec2 tex_side_first = second.texture_position - first.texture_position;
+        glm::vec2 tex_side_second = third.texture_position - first.texture_position;
+
+        GLfloat determinant = tex_side_first.x * tex_side_second.y - tex_side_second.x * tex_side_first.y;
+        if (std::abs(determinant) < std::numeric_limits<GLfloat>::epsilon()) {
+            continue;
+        }
+        GLfloat norm = 1.0f / determinant;
+        glm::vec3 tangent = (side_first * tex_side_second.y - side_second * tex_side_first.y) * norm;
+        glm::vec3 bitangent = (side_second * tex_side_first.x - side_first * tex_side_second.x) * norm;
+        for (size_t corner = 0; corner < 3; ++corner) {
+            tangents[indexes[idx + corner]] += tangent;
+            bitangents[indexes[idx + corner]] += bitangent;
+        }
+    }
+
+    // Касательная ортогонализуется к нормали, знак базиса берется из накопленной бикасательной
+    for (size_t idx = 0; idx < vertexes.size(); ++idx) {
+        Vertex &vertex = vertexes[idx];
+        if (!is_missing(vertex)) {
+            continue;
+        }
+        glm::vec3 tangent = tangents[idx] - vertex.normal * glm::dot(vertex.normal, tangents[idx]);
+        if (glm::dot(tangent, tangent) < std::numeric_limits<GLfloat>::epsilon()) {
+            tangent = glm::cross(vertex.normal, std::abs(vertex.normal.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f));
+        }
+        tangent = glm::normalize(tangent);
+
+        GLfloat handedness = glm::dot(glm::cross(vertex.normal, tangent), bitangents[idx]) < 0.0f ? -1.0f : 1.0f;
+        vertex.tangent = glm::vec4(tangent, handedness);
+    }
+}
+
+const MeshImportStats& MeshImporter::GetStats() {
+    return stats;
+}
+
+void MeshImporter::PrintStats() {
+    double size_mb = stats.bytes / (1024.0 * 1024.0);
+    std::cout << "MESH_IMPORTER::FILES " << stats.cnt_files << ", " << size_mb << " MB in " << stats.time.count() << " ms ("
+              << size_mb * 1000.0 / std::max(stats.time.count(), 1e-3) << " MB/s)" << std::endl;
+}
+
+size_t MeshImporter::ObjCornerHash::operator()(const ObjCorner& corner) const {
+    size_t hash = std::hash<int64_t>()(corner.position);
+    hash ^= std::hash<int64_t>()(corner.texture_position) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<int64_t>()(corner.normal) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+bool MeshImporter::ObjCornerEqual::operator()(const ObjCorner& lhs, const ObjCorner& rhs) const {
+    return lhs.position == rhs.position && lhs.texture_position == rhs.texture_position && lhs.normal == rhs.normal;
+}
+
+void MeshImporter::ParseObjChunk(std::string_view text, ObjChunk &chunk) {
+    const char *cursor = text.data();
+    const char *end = text.data() + text.size();
+
+    auto is_space = [](char symbol) { return symbol == ' ' || symbol == '\t'; };
+    auto skip_spaces = [&]() {
+        while (cursor < end && is_space(*cursor)) {
+            ++cursor;
+        }
+    };
+    auto parse_float = [&](GLfloat &value) {
+        skip_spaces();
+        if (cursor < end && *cursor == '+') {
+            ++cursor;
+        }
+        auto [next, error] = std::from_chars(cursor, end, value);
+        cursor = next;
+        return error == std::errc();
+    };
+    // Положительный индекс абсолютный, отрицательный отсчитывается от числа уже прочитанных элементов фрагмента
+    auto parse_index = [&](int64_t &index, size_t cnt_read, uint8_t &relative, uint8_t relative_bit) {
+        int64_t raw_index = 0;
+        auto [next, error] = std::from_chars(cursor, end, raw_index);
+        cursor = next;
+        if (error != std::errc() || raw_index == 0) {
+            return false;
+        }
+        if (raw_index > 0) {
+            index = raw_index - 1;
+        } else {
+            index = static_cast<int64_t>(cnt_read) + raw_index;
+            relative |= relative_bit;
+        }
+        return true;
+    };
+
+    std::vector<ObjCorner> face;
+    while (cursor < end && chunk.valid) {
+        skip_spaces();
+        size_t line_size = end - cursor;
+        bool valid_line = true;
+
+        if (line_size >= 2 && cursor[0] == 'v' && is_space(cursor[1])) {
+            cursor += 1;
+            glm::vec3 position;
+            valid_line = parse_float(position.x) && parse_float(position.y) && parse_float(position.z);
+            chunk.positions.push_back(position);
+        } else if (line_size >= 3 && cursor[0] == 'v' && cursor[1] == 't' && is_space(cursor[2])) {
+            cursor += 2;
+            glm::vec2 texture_position;
+            valid_line = parse_float(texture_position.x) && parse_float(texture_position.y);
+            // Текстуры загружаются без переворота, поэтому начало координат OBJ переносится в верхний левый угол
+            texture_position.y = 1.0f - texture_position.y;
+            chunk.texture_positions.push_back(texture_position);
+        } else if (line_size >= 3 && cursor[0] == 'v' && cursor[1] == 'n' && is_space(cursor[2])) {
+            cursor += 2;
+            glm::vec3 normal;
+            valid_line = parse_float(normal.x) && parse_float(normal.y) && parse_float(normal.z);
+            chunk.normals.push_back(normal);
+        } else if (line_size >= 2 && cursor[0] == 'f' && is_space(cursor[1])) {
+            cursor += 1;
+            face.clear();
+            while (valid_line) {
+                skip_spaces();
+                if (cursor >= end || *cursor == '\n' || *cursor == '\r' || *cursor == '#') {
+                    break;
+                }
+
+                ObjCorner corner{ NO_INDEX, NO_INDEX, NO_INDEX, 0 };
+                valid_line = parse_index(corner.position, chunk.positions.size(), corner.relative, 1);
+                if (valid_line && cursor < end && *cursor == '/') {
+                    ++cursor;
+                    if (cursor < end && *cursor != '/') {
+                        valid_line = parse_index(corner.texture_position, chunk.texture_positions.size(), corner.relative, 2);
+                    }
+                    if (valid_line && cursor < end && *cursor == '/') {
+                        ++cursor;
+                        valid_line = parse_index(corner.normal, chunk.normals.size(), corner.relative, 4);
+                    }
+                }
+                face.push_back(corner);
+            }
+
+            valid_line = valid_line && face.size() >= 3;
+            for (size_t idx = 1; valid_line && idx + 1 < face.size(); ++idx) {
+                chunk.corners.push_back(face[0]);
+                chunk.corners.push_back(face[idx]);
+                chunk.corners.push_back(face[idx + 1]);
+            }
+        }
+
+        chunk.valid = valid_line;
+        while (cursor < end && *cursor != '\n') {
+            ++cursor;
+        }
+        if (cursor < end) {
+            ++cursor;
+        }
+    }
+}
+
+bool MeshImporter::BuildObjChunk(const ObjChunk& chunk, const std::vector<glm::vec3>& positions,
+                                 const std::vector<glm::vec2>& texture_positions, const std::vector<glm::vec3>& normals,
+                                 const std::array<size_t, 3>& bases, MeshData& mesh_data) {
+    const std::array<size_t, 3> counts{ positions.size(), texture_positions.size(), normals.size() };
+
+    std::unordered_map<ObjCorner, GLuint, ObjCornerHash, ObjCornerEqual> unique_corners;
+    unique_corners.reserve(chunk.corners.size() / 2);
+    mesh_data.indexes.reserve(chunk.corners.size());
+    for (ObjCorner corner : chunk.corners) {
+        std::array<int64_t*, 3> corner_indexes{ &corner.position, &corner.texture_position, &corner.normal };
+        for (size_t attribute = 0; attribute < corner_indexes.size(); ++attribute) {
+            int64_t &index = *corner_indexes[attribute];
+            if (index == NO_INDEX) {
+                continue;
+            }
+            if (corner.relative & (1 << attribute)) {
+                index += static_cast<int64_t>(bases[attribute]);
+            }
+            if (index < 0 || index >= static_cast<int64_t>(counts[attribute])) {
+                return false;
+            }
+        }
+
+        auto [unique_corner, inserted] = unique_corners.emplace(corner, static_cast<GLuint>(mesh_data.vertexes.size()));
+        if (inserted) {
+            Vertex vertex;
+            vertex.position = positions[corner.position];
+            vertex.normal = corner.normal != NO_INDEX ? normals[corner.normal] : glm::vec3(0.0f);
+            vertex.texture_position = corner.texture_position != NO_INDEX ? texture_positions[corner.texture_position] : glm::vec2(0.0f);
+            vertex.tangent = glm::vec4(0.0f);
+            mesh_data.vertexes.push_back(vertex);
+        }
+        mesh_data.indexes.push_back(unique_corner->second);
+    }
+    return true;
+}
+
+std::vector<MeshImporter::GltfInstance> MeshImporter::GetGltfInstances(const JsonValue& document) {
+    std::vector<GltfInstance> instances;
+    const JsonValue &nodes = document["nodes"];
+    const JsonValue &scenes = document["scenes"];
+
+    // Без графа сцены каждый меш берется один раз в собственной системе координат
+    if (scenes.GetSize() == 0 || nodes.GetSize() == 0) {
+        for (size_t mesh = 0; mesh < document["meshes"].GetSize(); ++mesh) {
+            instances.push_back({ mesh, glm::mat4(1.0f) });
+        }
+        return instances;
+    }
+
+    std::vector<std::pair<size_t, glm::mat4>> stack;
+    for (const auto &root : scenes[GetGltfSize(document["scene"])]["nodes"].GetArray()) {
+        stack.emplace_back(GetGltfSize(root), glm::mat4(1.0f));
+    }
+
+    size_t cnt_visited = 0;
+    while (!stack.empty() && cnt_visited++ < nodes.GetSize()) {
+        auto [node_index, parent_world] = stack.back();
+        stack.pop_back();
+
+        const JsonValue &node = nodes[node_index];
+        glm::mat4 world = parent_world * GetGltfNodeMatrix(node);
+        if (node.Contains("mesh")) {
+            instances.push_back({ GetGltfSize(node["mesh"]), world });
+        }
+        for (const auto &child : node["children"].GetArray()) {
+            stack.emplace_back(GetGltfSize(child), world);
+        }
+    }
+    return instances;
+}
+
+glm::mat4 MeshImporter::GetGltfNodeMatrix(const JsonValue& node) {
+    glm::mat4 matrix(1.0f);
+    const JsonValue &node_matrix = node["matrix"];
+    if (node_matrix.GetSize() == 16) {
+        for (int column = 0; column < 4; ++column) {
+            for (int row = 0; row < 4; ++row) {
+                matrix[column][row] = static_cast<GLfloat>(node_matrix[4 * column + row].GetNumber());
+            }
+        }
+        return matrix;
+    }
+
+    const JsonValue &translation = node["translation"];
+    const JsonValue &rotation = node["rotation"];
+    const JsonValue &scale = node["scale"];
+    GLfloat x = static_cast<GLfloat>(rotation[0].GetNumber(0.0));
+    GLfloat y = static_cast<GLfloat>(rotation[1].GetNumber(0.0));
+    GLfloat z = static_cast<GLfloat>(rotation[2].GetNumber(0.0));
+    GLfloat w = static_cast<GLfloat>(rotation[3].GetNumber(1.0));
+
+    // T * R * S, поворот задан единичным кватернионом (x, y, z, w)
+    matrix[0] = glm::vec4(1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y), 0.0f)
+              * static_cast<GLfloat>(scale[0].GetNumber(1.0));
+    matrix[1] = glm::vec4(2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x), 0.0f)
+              * static_cast<GLfloat>(scale[1].GetNumber(1.0));
+    matrix[2] = glm::vec4(2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y), 0.0f)
+              * static_cast<GLfloat>(scale[2].GetNumber(1.0));
+    matrix[3] = glm::vec4(static_cast<GLfloat>(translation[0].GetNumber(0.0)), static_cast<GLfloat>(translation[1].GetNumber(0.0)),
+                          static_cast<GLfloat>(translation[2].GetNumber(0.0)), 1.0f);
+    return matrix;
+}
+
+std::optional<MeshImporter::GltfAccessor> MeshImporter::GetGltfAccessor(const JsonValue& document, const JsonValue& accessor_info,
+                                                                         std::string_view binary) {
+    if (accessor_info.IsNull() || accessor_info.Contains("sparse") || !accessor_info.Contains("bufferView")) {
+        return std::nullopt;
+    }
+    const JsonValue &view = document["bufferViews"][GetGltfSize(accessor_info["bufferView"])];
+    if (view.IsNull() || GetGltfSize(view["buffer"]) != 0) {
+        return std::nullopt;
+    }
+
+    GltfAccessor accessor;
+    const std::string &type = accessor_info["type"].GetString();
+    accessor.components = type == "SCALAR" ? 1 : type == "VEC2" ? 2 : type == "VEC3" ? 3 : type == "VEC4" ? 4 : 0;
+    accessor.component_type = static_cast<GLenum>(GetGltfSize(accessor_info["componentType"]));
+    accessor.normalized = accessor_info["normalized"].GetBoolean();
+    accessor.count = GetGltfSize(accessor_info["count"]);
+
+    size_t component_size = 0;
+    switch (accessor.component_type) {
+    case GL_BYTE:
+    case GL_UNSIGNED_BYTE:
+        component_size = sizeof(GLubyte);
+        break;
+    case GL_SHORT:
+    case GL_UNSIGNED_SHORT:
+        component_size = sizeof(GLushort);
+        break;
+    case GL_UNSIGNED_INT:
+    case GL_FLOAT:
+        component_size = sizeof(GLuint);
+        break;
+    default:
+        return std::nullopt;
+    }
+    if (accessor.components == 0) {
+        return std::nullopt;
+    }
+
+    size_t element_size = accessor.components * component_size;
+    size_t view_offset = GetGltfSize(view["byteOffset"]);
+    size_t view_length = GetGltfSize(view["byteLength"]);
+    size_t offset = GetGltfSize(accessor_info["byteOffset"]);
+    accessor.stride = GetGltfSize(view["byteStride"], element_size);
+    if (view_offset + view_length > binary.size() ||
+        (accessor.count > 0 && offset + accessor.stride * (accessor.count - 1) + element_size > view_length)) {
+        return std::nullopt;
+    }
+
+    accessor.data = binary.data() + view_offset + offset;
+    return accessor;
+}
+
+size_t MeshImporter::GetGltfSize(const JsonValue& value, size_t default_value) {
+    double number = value.GetNumber(-1.0);
+    return number >= 0.0 ? static_cast<size_t>(number) : default_value;
+}
+
+GLfloat MeshImporter::ReadGltfComponent(const GltfAccessor& accessor, size_t element, size_t component) {
+    const char *source = accessor.data + element * accessor.stride;
+    switch (accessor.component_type) {
+    case GL_FLOAT: {
+        GLfloat value;
+        std::memcpy(&value, source + component * sizeof(GLfloat), sizeof(GLfloat));
+        return value;
+    }
+    case GL_UNSIGNED_BYTE: {
+        GLubyte value = static_cast<GLubyte>(source[component]);
+        return accessor.normalized ? value / 255.0f : value;
+    }
+    case GL_BYTE: {
+        GLbyte value = static_cast<GLbyte>(source[component]);
+        return accessor.normalized ? std::max(value / 127.0f, -1.0f) : value;
+    }
+    case GL_UNSIGNED_SHORT: {
+        GLushort value;
+        std::memcpy(&value, source + component * sizeof(GLushort), sizeof(GLushort));
+        return accessor.normalized ? value / 65535.0f : value;
+    }
+    case GL_SHORT: {
+        GLshort value;
+        std::memcpy(&value, source + component * sizeof(GLshort), sizeof(GLshort));
+        return accessor.normalized ? std::max(value / 32767.0f, -1.0f) : value;
+    }
+    default: {
+        GLuint value;
+        std::memcpy(&value, source + component * sizeof(GLuint), sizeof(GLuint));
+        return static_cast<GLfloat>(value);
+    }
+    }
+}
+
+GLuint MeshImporter::ReadGltfIndex(const GltfAccessor& accessor, size_t element) {
+    const char *source = accessor.data + element * accessor.stride;
+    switch (accessor.component_type) {
+    case GL_UNSIGNED_BYTE:
+        return static_cast<GLubyte>(source[0]);
+    case GL_UNSIGNED_SHORT: {
+        GLushort value;
+        std::memcpy(&value, source, sizeof(GLushort));
+        return value;
+    }
+    default: {
+        GLuint value;
+        std::memcpy(&value, source, sizeof(GLuint));
+        return value;
+    }
+    }
+}
+
+bool MeshImporter::BuildGltfPrimitive(const JsonValue& document, const JsonValue& primitive, const glm::mat4& world,
+                                      std::string_view binary, MeshData& mesh_data) {
+    if (GetGltfSize(primitive["mode"], GL_TRIANGLES) != GL_TRIANGLES) {
+        return false;
+    }
+
+    const JsonValue &attributes = primitive["attributes"];
+    const JsonValue &accessors = document["accessors"];
+    auto get_accessor = [&](std::string_view name, size_t components, size_t count, bool &valid) {
+        std::optional<GltfAccessor> accessor;
+        if (attributes.Contains(name)) {
+            accessor = GetGltfAccessor(document, accessors[GetGltfSize(attributes[name])], binary);
+            valid = valid && accessor && accessor->components == components && (count == 0 || accessor->count == count);
+        }
+        return accessor;
+    };
+
+    bool valid = attributes.Contains("POSITION");
+    std::optional<GltfAccessor> positions = get_accessor("POSITION", 3, 0, valid);
+    if (!valid) {
+        return false;
+    }
+    std::optional<GltfAccessor> normals = get_accessor("NORMAL", 3, positions->count, valid);
+    std::optional<GltfAccessor> texture_positions = get_accessor("TEXCOORD_0", 2, positions->count, valid);
+    std::optional<GltfAccessor> tangents = get_accessor("TANGENT", 4, positions->count, valid);
+    if (!valid) {
+        return false;
+    }
+
+    glm::mat3 model(world);
+    glm::mat3 normal_model = glm::transpose(glm::inverse(model));
+    mesh_data.vertexes.resize(positions->count);
+    for (size_t idx = 0; idx < positions->count; ++idx) {
+        Vertex &vertex = mesh_data.vertexes[idx];
+        glm::vec4 position = world * glm::vec4(ReadGltfComponent(*positions, idx, 0), ReadGltfComponent(*positions, idx, 1),
+                                               ReadGltfComponent(*positions, idx, 2), 1.0f);
+        vertex.position = glm::vec3(position.x, position.y, position.z);
+
+        vertex.normal = glm::vec3(0.0f);
+        if (normals) {
+            glm::vec3 normal = normal_model * glm::vec3(ReadGltfComponent(*normals, idx, 0), ReadGltfComponent(*normals, idx, 1),
+                                                        ReadGltfComponent(*normals, idx, 2));
+            GLfloat length = glm::length(normal);
+            vertex.normal = length > 0.0f ? normal / length : glm::vec3(0.0f);
+        }
+
+        vertex.texture_position = glm::vec2(0.0f);
+        if (texture_positions) {
+            vertex.texture_position = glm::vec2(ReadGltfComponent(*texture_positions, idx, 0), ReadGltfComponent(*texture_positions, idx, 1));
+        }
+
+        vertex.tangent = glm::vec4(0.0f);
+        if (tangents && glm::dot(vertex.normal, vertex.normal) > 0.0f) {
+            glm::vec3 tangent = model * glm::vec3(ReadGltfComponent(*tangents, idx, 0), ReadGltfComponent(*tangents, idx, 1),
+                                                  ReadGltfComponent(*tangents, idx, 2));
+            GLfloat length = glm::length(tangent);
+            if (length > 0.0f) {
+                GLfloat handedness = ReadGltfComponent(*tangents, idx, 3) < 0.0f ? -1.0f : 1.0f;
+                vertex.tangent = glm::vec4(tangent / length, handedness);
+            }
+        }
+    }
+
+    if (primitive.Contains("indices")) {
+        std::optional<GltfAccessor> indexes = GetGltfAccessor(document, accessors[GetGltfSize(primitive["indices"])], binary);
+        if (!indexes || indexes->components != 1 || indexes->component_type == GL_FLOAT ||
+            indexes->component_type == GL_BYTE || indexes->component_type == GL_SHORT) {
+            return false;
+        }
+        mesh_data.indexes.resize(indexes->count);
+        for (size_t idx = 0; idx < indexes->count; ++idx) {
+            mesh_data.indexes[idx] = ReadGltfIndex(*indexes, idx);
+            if (mesh_data.indexes[idx] >= positions->count) {
+                return false;
+            }
+        }
+    } else {
+        mesh_data.indexes.resize(positions->count);
+        std::iota(mesh_data.indexes.begin(), mesh_data.indexes.end(), 0);
+    }
+    mesh_data.indexes.resize(mesh_data.indexes.size() - mesh_data.indexes.size() % 3);
+
+    // Зеркальное преобразование узла меняет обход треугольников
+    if (glm::determinant(model) < 0.0f) {
+        for (size_t idx = 0; idx + 2 < mesh_data.indexes.size(); idx += 3) {
+            std::swap(mesh_data.indexes[idx + 1], mesh_data.indexes[idx + 2]);
+        }
+    }
+    return true;
+}
+
+void MeshImporter::ParallelFor(size_t cnt_items, const std::function<void(size_t)>& function) {
+    size_t cnt_threads = std::min<size_t>(cnt_items, std::max<size_t>(std::thread::hardware_concurrency(), 1));
+    std::atomic<size_t> next_item{ 0 };
+    auto worker = [&]() {
+        size_t item;
+        while ((item = next_item.fetch_add(1)) < cnt_items) {
+            function(item);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t idx = 1; idx < cnt_threads; ++idx) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : workers) {
+        thread.join();
+    }
+}
+
+MeshData MeshImporter::MergeMeshData(std::vector<MeshData>& meshes) {
+    std::vector<size_t> vertex_bases(meshes.size() + 1, 0);
+    std::vector<size_t> index_bases(meshes.size() + 1, 0);
+    for (size_t idx = 0; idx < meshes.size(); ++idx) {
+        vertex_bases[idx + 1] = vertex_bases[idx] + meshes[idx].vertexes.size();
+        index_bases[idx + 1] = index_bases[idx] + meshes[idx].indexes.size();
+    }
+
+    MeshData mesh_data;
+    mesh_data.vertexes.resize(vertex_bases.back());
+    mesh_data.indexes.resize(index_bases.back());
+    ParallelFor(meshes.size(), [&](size_t idx) {
+        GLuint vertex_base = static_cast<GLuint>(vertex_bases[idx]);
+        std::copy(meshes[idx].vertexes.begin(), meshes[idx].vertexes.end(), mesh_data.vertexes.begin() + vertex_bases[idx]);
+        std::transform(meshes[idx].indexes.begin(), meshes[idx].indexes.end(), mesh_data.indexes.begin() + index_bases[idx],
+                       [vertex_base](GLuint index) { return index + vertex_base; });
+        meshes[idx] = MeshData();
+    });
+    return mesh_data;
+}
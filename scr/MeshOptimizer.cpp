@@ -0,0 +1,257 @@
+﻿#include "../libs/MeshOptimizer.h"
+
+
+void MeshOptimizer::OptimizeMesh(MeshData &mesh_data) {
+    auto &[vertexes, indexes] = mesh_data;
+    if (indexes.empty() || indexes.size() % 3 != 0) {
+        return;
+    }
+    if (*std::max_element(indexes.begin(), indexes.end()) >= vertexes.size()) {
+        std::cerr << "ERROR::MESH_OPTIMIZER::INDEX_OUT_OF_RANGE" << std::endl;
+        return;
+    }
+
+    VertexCacheStats stats_before = AnalyzeVertexCache(indexes, vertexes.size());
+
+    std::vector<size_t> clusters;
+    indexes = OptimizeVertexCache(indexes, vertexes.size(), clusters);
+    OptimizeOverdraw(indexes, vertexes, clusters);
+    OptimizeVertexFetch(mesh_data);
+
+    VertexCacheStats stats_after = AnalyzeVertexCache(indexes, vertexes.size());
+    std::cout << "MESH_OPTIMIZER::ACMR " << stats_before.acmr << " -> " << stats_after.acmr << ", "
+              << "ATVR " << stats_before.atvr << " -> " << stats_after.atvr
+              << " (" << indexes.size() / 3 << " TRIANGLES)" << std::endl;
+}
+
+std::vector<GLuint> MeshOptimizer::OptimizeVertexCache(const std::vector<GLuint>& indexes, size_t cnt_vertexes,
+                                                       std::vector<size_t>& clusters) {
+    size_t cnt_triangles = indexes.size() / 3;
+
+    std::vector<GLuint> live_triangles(cnt_vertexes, 0);
+    for (GLuint index : indexes) {
+        ++live_triangles[index];
+    }
+
+    std::vector<size_t> adjacency_offsets(cnt_vertexes + 1, 0);
+    for (size_t vertex = 0; vertex < cnt_vertexes; ++vertex) {
+        adjacency_offsets[vertex + 1] = adjacency_offsets[vertex] + live_triangles[vertex];
+    }
+    std::vector<size_t> adjacency(indexes.size());
+    std::vector<size_t> adjacency_fill(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+    for (size_t triangle = 0; triangle < cnt_triangles; ++triangle) {
+        for (size_t corner = 0; corner < 3; ++corner) {
+            adjacency[adjacency_fill[indexes[3 * triangle + corner]]++] = triangle;
+        }
+    }
+
+    std::vector<size_t> cache_time(cnt_vertexes, 0);
+    std::vector<bool> emitted(cnt_triangles, false);
+    std::vector<GLuint> dead_end;
+    std::vector<GLuint> candidates;
+    std::vector<GLuint> optimized_indexes;
+    optimized_indexes.reserve(indexes.size());
+
+    size_t time_stamp = VERTEX_CACHE_SIZE + 1;
+    size_t cursor = 0;
+
+    // Тупик: берем последнюю вершину стека с живыми треугольниками, иначе следующую по входному порядку
+    auto skip_dead_end = [&]() -> int64_t {
+        while (!dead_end.empty()) {
+            GLuint vertex = dead_end.back();
+            dead_end.pop_back();
+            if (live_triangles[vertex] > 0) {
+                return vertex;
+            }
+        }
+        for (; cursor < cnt_vertexes; ++cursor) {
+            if (live_triangles[cursor] > 0) {
+                return static_cast<int64_t>(cursor);
+            }
+        }
+        return -1;
+    };
+
+    clusters.assign(1, 0);
+    int64_t fanning = skip_dead_end();
+    while (fanning >= 0) {
+        candidates.clear();
+        for (size_t adjacent = adjacency_offsets[fanning]; adjacent < adjacency_offsets[fanning + 1]; ++adjacent) {
+            size_t triangle = adjacency[adjacent];
+            if (emitted[triangle]) {
+                continue;
+            }
+            for (size_t corner = 0; corner < 3; ++corner) {
+                GLuint vertex = indexes[3 * triangle + corner];
+                optimized_indexes.push_back(vertex);
+                dead_end.push_back(vertex);
+                candidates.push_back(vertex);
+                --live_triangles[vertex];
+                TouchVertex(vertex, cache_time, time_stamp);
+            }
+            emitted[triangle] = true;
+        }
+
+        // Следующий веер строится вокруг вершины, которая останется в кэше после выдачи всех ее треугольников
+        int64_t next = -1;
+        int64_t best_priority = -1;
+        for (GLuint vertex : candidates) {
+            if (live_triangles[vertex] == 0) {
+                continue;
+            }
+            int64_t priority = 0;
+            if (time_stamp - cache_time[vertex] + 2 * live_triangles[vertex] <= VERTEX_CACHE_SIZE) {
+                priority = static_cast<int64_t>(time_stamp - cache_time[vertex]);
+            }
+            if (priority > best_priority) {
+                best_priority = priority;
+                next = vertex;
+            }
+        }
+
+        if (next < 0) {
+            next = skip_dead_end();
+            size_t boundary = optimized_indexes.size() / 3;
+            if (next >= 0 && clusters.back() != boundary) {
+                clusters.push_back(boundary);
+            }
+        }
+        fanning = next;
+    }
+
+    return optimized_indexes;
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<GLuint>& indexes, const std::vector<Vertex>& vertexes,
+                                     const std::vector<size_t>& hard_clusters) {
+    size_t cnt_triangles = indexes.size() / 3;
+    if (cnt_triangles == 0) {
+        return;
+    }
+
+    // Жесткие кластеры дробятся там, где ACMR накопленной части не хуже ACMR всего кластера с допуском
+    std::vector<size_t> clusters;
+    std::vector<size_t> cache_time(vertexes.size(), 0);
+    size_t time_stamp = VERTEX_CACHE_SIZE + 1;
+    for (size_t idx = 0; idx < hard_clusters.size(); ++idx) {
+        size_t begin = hard_clusters[idx];
+        size_t end = idx + 1 < hard_clusters.size() ? hard_clusters[idx + 1] : cnt_triangles;
+        if (begin >= end) {
+            continue;
+        }
+
+        time_stamp += VERTEX_CACHE_SIZE + 1;
+        size_t cluster_misses = 0;
+        for (size_t index = 3 * begin; index < 3 * end; ++index) {
+            cluster_misses += TouchVertex(indexes[index], cache_time, time_stamp);
+        }
+        GLfloat threshold = OVERDRAW_THRESHOLD * cluster_misses / (end - begin);
+
+        clusters.push_back(begin);
+        time_stamp += VERTEX_CACHE_SIZE + 1;
+        size_t start = begin;
+        size_t misses = 0;
+        for (size_t triangle = begin; triangle + 1 < end; ++triangle) {
+            for (size_t corner = 0; corner < 3; ++corner) {
+                misses += TouchVertex(indexes[3 * triangle + corner], cache_time, time_stamp);
+            }
+            if (misses <= threshold * (triangle + 1 - start)) {
+                clusters.push_back(triangle + 1);
+                time_stamp += VERTEX_CACHE_SIZE + 1;
+                start = triangle + 1;
+                misses = 0;
+            }
+        }
+    }
+
+    glm::vec3 mesh_centroid(0.0f);
+    for (GLuint index : indexes) {
+        mesh_centroid += vertexes[index].position;
+    }
+    mesh_centroid /= static_cast<GLfloat>(indexes.size());
+
+    // Кластеры, обращенные наружу от центра меша, рисуются первыми и закрывают внутренние
+    std::vector<std::pair<GLfloat, size_t>> cluster_keys;
+    cluster_keys.reserve(clusters.size());
+    for (size_t idx = 0; idx < clusters.size(); ++idx) {
+        size_t begin = clusters[idx];
+        size_t end = idx + 1 < clusters.size() ? clusters[idx + 1] : cnt_triangles;
+
+        glm::vec3 centroid(0.0f);
+        glm::vec3 normal(0.0f);
+        for (size_t triangle = begin; triangle < end; ++triangle) {
+            const glm::vec3 &first = vertexes[indexes[3 * triangle]].position;
+            const glm::vec3 &second = vertexes[indexes[3 * triangle + 1]].position;
+            const glm::vec3 &third = vertexes[indexes[3 * triangle + 2]].position;
+            centroid += (first + second + third) / 3.0f;
+            normal += glm::cross(second - first, third - first);
+        }
+        centroid /= static_cast<GLfloat>(end - begin);
+
+        GLfloat normal_length = glm::length(normal);
+        GLfloat key = normal_length > 0.0f ? glm::dot(centroid - mesh_centroid, normal / normal_length) : 0.0f;
+        cluster_keys.emplace_back(key, idx);
+    }
+    std::stable_sort(cluster_keys.begin(), cluster_keys.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.first > rhs.first;
+    });
+
+    std::vector<GLuint> sorted_indexes;
+    sorted_indexes.reserve(indexes.size());
+    for (const auto &[key, idx] : cluster_keys) {
+        size_t begin = clusters[idx];
+        size_t end = idx + 1 < clusters.size() ? clusters[idx + 1] : cnt_triangles;
+        sorted_indexes.insert(sorted_indexes.end(), indexes.begin() + 3 * begin, indexes.begin() + 3 * end);
+    }
+    indexes.swap(sorted_indexes);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(MeshData &mesh_data) {
+    constexpr GLuint UNUSED_VERTEX = std::numeric_limits<GLuint>::max();
+
+    auto &[vertexes, indexes] = mesh_data;
+    std::vector<GLuint> remap(vertexes.size(), UNUSED_VERTEX);
+    std::vector<Vertex> fetch_vertexes;
+    fetch_vertexes.reserve(vertexes.size());
+    for (GLuint &index : indexes) {
+        if (remap[index] == UNUSED_VERTEX) {
+            remap[index] = static_cast<GLuint>(fetch_vertexes.size());
+            fetch_vertexes.push_back(vertexes[index]);
+        }
+        index = remap[index];
+    }
+    vertexes.swap(fetch_vertexes);
+}
+
+VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const std::vector<GLuint>& indexes, size_t cnt_vertexes) {
+    VertexCacheStats stats;
+    if (indexes.empty()) {
+        return stats;
+    }
+
+    std::vector<size_t> cache_time(cnt_vertexes, 0);
+    std::vector<bool> referenced(cnt_vertexes, false);
+    size_t time_stamp = VERTEX_CACHE_SIZE + 1;
+    size_t misses = 0;
+    size_t cnt_referenced = 0;
+    for (GLuint index : indexes) {
+        misses += TouchVertex(index, cache_time, time_stamp);
+        if (!referenced[index]) {
+            referenced[index] = true;
+            ++cnt_referenced;
+        }
+    }
+
+    stats.acmr = static_cast<GLfloat>(misses) / (indexes.size() / 3);
+    stats.atvr = static_cast<GLfloat>(misses) / cnt_referenced;
+    return stats;
+}
+
+bool MeshOptimizer::TouchVertex(GLuint vertex, std::vector<size_t>& cache_time, size_t& time_stamp) {
+    // FIFO-кэш по меткам времени: вершина в кэше, пока после нее загружено не больше VERTEX_CACHE_SIZE вершин
+    if (time_stamp - cache_time[vertex] > VERTEX_CACHE_SIZE) {
+        cache_time[vertex] = time_stamp++;
+        return true;
+    }
+    return false;
+}
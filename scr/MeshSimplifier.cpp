@@ -0,0 +1,331 @@
+﻿#include "../libs/MeshSimplifier.h"
+
+
+std::vector<MeshLodData> MeshSimplifier::GenerateLods(const MeshData& mesh_data) {
+    const auto &vertexes = mesh_data.vertexes;
+    std::vector<MeshLodData> lods;
+    if (vertexes.empty() || mesh_data.indexes.size() < 2 * MIN_LOD_TRIANGLES * 3) {
+        return lods;
+    }
+
+    glm::vec3 bounds_min = vertexes.front().position;
+    glm::vec3 bounds_max = vertexes.front().position;
+    for (const auto &vertex : vertexes) {
+        bounds_min = glm::min(bounds_min, vertex.position);
+        bounds_max = glm::max(bounds_max, vertex.position);
+    }
+    GLfloat max_error = MAX_LOD_ERROR * 0.5f * glm::length(bounds_max - bounds_min);
+
+    // Каждый LOD строится из предыдущего, ошибки цепочки складываются
+    lods.reserve(MAX_LODS - 1);
+    const std::vector<GLuint> *source_indexes = &mesh_data.indexes;
+    GLfloat source_error = 0.0f;
+    while (lods.size() + 1 < MAX_LODS && source_error < max_error) {
+        size_t target_cnt_indexes = static_cast<size_t>(source_indexes->size() / 3 * LOD_REDUCTION) * 3;
+        if (target_cnt_indexes < MIN_LOD_TRIANGLES * 3) {
+            break;
+        }
+
+        GLfloat error = 0.0f;
+        std::vector<GLuint> indexes = Simplify(vertexes, *source_indexes, target_cnt_indexes, max_error - source_error, error);
+        if (indexes.size() > source_indexes->size() * MIN_LOD_REDUCTION) {
+            break;
+        }
+
+        std::vector<size_t> clusters;
+        lods.push_back({ MeshOptimizer::OptimizeVertexCache(indexes, vertexes.size(), clusters), source_error + error });
+        source_indexes = &lods.back().indexes;
+        source_error = lods.back().error;
+        std::cout << "MESH_SIMPLIFIER::LOD " << lods.size() << ": " << indexes.size() / 3 << " TRIANGLES, ERROR "
+                  << source_error << std::endl;
+    }
+    return lods;
+}
+
+std::vector<GLuint> MeshSimplifier::Simplify(const std::vector<Vertex>& vertexes, const std::vector<GLuint>& source_indexes,
+                                             size_t target_cnt_indexes, GLfloat target_error, GLfloat& result_error) {
+    std::vector<GLuint> indexes = source_indexes;
+    result_error = 0.0f;
+    if (indexes.size() <= target_cnt_indexes || indexes.size() % 3 != 0) {
+        return indexes;
+    }
+
+    // Вершины с одной позицией, но разными атрибутами, образуют шов и сжимаются как одна позиция
+    std::vector<GLuint> position_remap = GetPositionRemap(vertexes);
+    std::vector<GLuint> cnt_wedges(vertexes.size(), 0);
+    std::vector<bool> used(vertexes.size(), false);
+    for (GLuint index : indexes) {
+        if (!used[index]) {
+            used[index] = true;
+            ++cnt_wedges[position_remap[index]];
+        }
+    }
+
+    std::vector<VertexKind> kinds(vertexes.size(), VertexKind::MANIFOLD);
+    std::unordered_map<uint64_t, GLuint> edge_counts = CountEdges(indexes, position_remap);
+    for (const auto &[edge, count] : edge_counts) {
+        VertexKind kind = count == 1 ? VertexKind::BORDER : (count == 2 ? VertexKind::MANIFOLD : VertexKind::LOCKED);
+        for (GLuint position : { static_cast<GLuint>(edge >> 32), static_cast<GLuint>(edge & 0xFFFFFFFF) }) {
+            kinds[position] = std::max(kinds[position], kind);
+        }
+    }
+    for (size_t position = 0; position < vertexes.size(); ++position) {
+        if (cnt_wedges[position] > 1) {
+            kinds[position] = VertexKind::LOCKED;
+        }
+    }
+
+    // Квадрики граней с весом по площади; граничные ребра добавляют перпендикулярные плоскости, удерживающие контур
+    std::vector<Quadric> quadrics(vertexes.size(), Quadric{});
+    for (size_t idx = 0; idx < indexes.size(); idx += 3) {
+        GLuint corners[3] = { position_remap[indexes[idx]], position_remap[indexes[idx + 1]], position_remap[indexes[idx + 2]] };
+        const glm::vec3 &p0 = vertexes[corners[0]].position;
+        glm::vec3 normal = glm::cross(vertexes[corners[1]].position - p0, vertexes[corners[2]].position - p0);
+        GLfloat length = glm::length(normal);
+        if (length == 0.0f) {
+            continue;
+        }
+        normal /= length;
+        for (GLuint corner : corners) {
+            AddPlane(quadrics[corner], normal, -glm::dot(normal, p0), 0.5 * length);
+        }
+
+        for (size_t edge = 0; edge < 3; ++edge) {
+            GLuint from = corners[edge];
+            GLuint to = corners[(edge + 1) % 3];
+            if (edge_counts[GetEdgeKey(from, to)] != 1) {
+                continue;
+            }
+            glm::vec3 direction = vertexes[to].position - vertexes[from].position;
+            GLfloat edge_length = glm::length(direction);
+            if (edge_length == 0.0f) {
+                continue;
+            }
+            glm::vec3 border_normal = glm::normalize(glm::cross(direction / edge_length, normal));
+            GLfloat distance = -glm::dot(border_normal, vertexes[from].position);
+            AddPlane(quadrics[from], border_normal, distance, BORDER_WEIGHT * edge_length * edge_length);
+            AddPlane(quadrics[to], border_normal, distance, BORDER_WEIGHT * edge_length * edge_length);
+        }
+    }
+
+    double max_error = static_cast<double>(target_error) * target_error;
+    double collapsed_error = 0.0;
+    std::vector<GLuint> collapse_remap(vertexes.size());
+    std::vector<bool> locked(vertexes.size());
+    std::vector<size_t> adjacency_offsets(vertexes.size() + 1);
+    std::vector<size_t> adjacency;
+    for (size_t pass = 0; pass < MAX_PASSES && indexes.size() > target_cnt_indexes; ++pass) {
+        if (pass != 0) {
+            edge_counts = CountEdges(indexes, position_remap);
+        }
+
+        // Треугольники вокруг каждой позиции для проверки переворота граней
+        std::fill(adjacency_offsets.begin(), adjacency_offsets.end(), 0);
+        for (GLuint index : indexes) {
+            ++adjacency_offsets[position_remap[index] + 1];
+        }
+        std::partial_sum(adjacency_offsets.begin(), adjacency_offsets.end(), adjacency_offsets.begin());
+        adjacency.resize(indexes.size());
+        std::vector<size_t> fill_offsets(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+        for (size_t idx = 0; idx < indexes.size(); ++idx) {
+            adjacency[fill_offsets[position_remap[indexes[idx]]]++] = idx / 3;
+        }
+
+        // Для каждой позиции оставляем самое дешевое допустимое сжатие
+        std::vector<Collapse> best_collapses(vertexes.size(), Collapse{ 0, 0, std::numeric_limits<double>::infinity() });
+        for (size_t idx = 0; idx < indexes.size(); ++idx) {
+            GLuint edge_indexes[2] = { indexes[idx], indexes[idx - idx % 3 + (idx + 1) % 3] };
+            for (size_t direction = 0; direction < 2; ++direction) {
+                GLuint from = edge_indexes[direction];
+                GLuint to = edge_indexes[1 - direction];
+                GLuint from_position = position_remap[from];
+                GLuint to_position = position_remap[to];
+                if (from_position == to_position || kinds[from_position] == VertexKind::LOCKED) {
+                    continue;
+                }
+                if (kinds[from_position] == VertexKind::BORDER && edge_counts[GetEdgeKey(from_position, to_position)] != 1) {
+                    continue;
+                }
+                double error = EvaluateQuadric(quadrics[from_position], vertexes[to].position);
+                if (error < best_collapses[from_position].error) {
+                    best_collapses[from_position] = Collapse{ from, to, error };
+                }
+            }
+        }
+
+        std::vector<Collapse> collapses;
+        for (const auto &collapse : best_collapses) {
+            if (collapse.error <= max_error) {
+                collapses.push_back(collapse);
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(),
+                  [](const Collapse &lhs, const Collapse &rhs) { return lhs.error < rhs.error; });
+
+        // Сжатие закрепляет все вершины вокруг себя до конца прохода, поэтому проверки соседних сжатий остаются верными
+        std::iota(collapse_remap.begin(), collapse_remap.end(), 0);
+        std::fill(locked.begin(), locked.end(), false);
+        size_t cnt_removed_triangles = 0;
+        size_t cnt_target_removed = (indexes.size() - target_cnt_indexes) / 3;
+        size_t cnt_collapses = 0;
+        for (const auto &collapse : collapses) {
+            if (cnt_removed_triangles >= cnt_target_removed) {
+                break;
+            }
+            GLuint from_position = position_remap[collapse.from];
+            GLuint to_position = position_remap[collapse.to];
+            if (locked[from_position] || locked[to_position]) {
+                continue;
+            }
+            if (HasFlip(vertexes, indexes, position_remap, adjacency_offsets, adjacency,
+                        from_position, to_position, vertexes[collapse.to].position)) {
+                continue;
+            }
+
+            for (size_t adjacent = adjacency_offsets[from_position]; adjacent < adjacency_offsets[from_position + 1]; ++adjacent) {
+                size_t triangle = adjacency[adjacent];
+                bool removed = false;
+                for (size_t corner = 0; corner < 3; ++corner) {
+                    GLuint position = position_remap[indexes[triangle * 3 + corner]];
+                    locked[position] = true;
+                    removed = removed || position == to_position;
+                }
+                cnt_removed_triangles += removed;
+            }
+            collapse_remap[collapse.from] = collapse.to;
+            AddQuadric(quadrics[to_position], quadrics[from_position]);
+            collapsed_error = std::max(collapsed_error, collapse.error);
+            ++cnt_collapses;
+        }
+        if (cnt_collapses == 0) {
+            break;
+        }
+
+        size_t cnt_indexes = 0;
+        for (size_t idx = 0; idx < indexes.size(); idx += 3) {
+            GLuint triangle[3] = { collapse_remap[indexes[idx]], collapse_remap[indexes[idx + 1]], collapse_remap[indexes[idx + 2]] };
+            GLuint positions[3] = { position_remap[triangle[0]], position_remap[triangle[1]], position_remap[triangle[2]] };
+            if (positions[0] == positions[1] || positions[1] == positions[2] || positions[0] == positions[2]) {
+                continue;
+            }
+            indexes[cnt_indexes++] = triangle[0];
+            indexes[cnt_indexes++] = triangle[1];
+            indexes[cnt_indexes++] = triangle[2];
+        }
+        indexes.resize(cnt_indexes);
+    }
+
+    result_error = static_cast<GLfloat>(std::sqrt(collapsed_error));
+    return indexes;
+}
+
+std::vector<GLuint> MeshSimplifier::GetPositionRemap(const std::vector<Vertex>& vertexes) {
+    std::vector<GLuint> order(vertexes.size());
+    std::iota(order.begin(), order.end(), 0);
+    auto position_less = [&vertexes](GLuint lhs, GLuint rhs) {
+        const glm::vec3 &lhs_position = vertexes[lhs].position;
+        const glm::vec3 &rhs_position = vertexes[rhs].position;
+        if (lhs_position.x != rhs_position.x) {
+            return lhs_position.x < rhs_position.x;
+        }
+        if (lhs_position.y != rhs_position.y) {
+            return lhs_position.y < rhs_position.y;
+        }
+        return lhs_position.z < rhs_position.z;
+    };
+    std::sort(order.begin(), order.end(), position_less);
+
+    std::vector<GLuint> position_remap(vertexes.size());
+    for (size_t idx = 0; idx < order.size(); ++idx) {
+        bool same_position = idx != 0 && !position_less(order[idx - 1], order[idx]);
+        position_remap[order[idx]] = same_position ? position_remap[order[idx - 1]] : order[idx];
+    }
+    return position_remap;
+}
+
+std::unordered_map<uint64_t, GLuint> MeshSimplifier::CountEdges(const std::vector<GLuint>& indexes,
+                                                                const std::vector<GLuint>& position_remap) {
+    std::unordered_map<uint64_t, GLuint> edge_counts;
+    edge_counts.reserve(indexes.size());
+    for (size_t idx = 0; idx < indexes.size(); ++idx) {
+        GLuint from = position_remap[indexes[idx]];
+        GLuint to = position_remap[indexes[idx - idx % 3 + (idx + 1) % 3]];
+        if (from != to) {
+            ++edge_counts[GetEdgeKey(from, to)];
+        }
+    }
+    return edge_counts;
+}
+
+uint64_t MeshSimplifier::GetEdgeKey(GLuint lhs, GLuint rhs) {
+    return (uint64_t(std::min(lhs, rhs)) << 32) | std::max(lhs, rhs);
+}
+
+void MeshSimplifier::AddPlane(Quadric& quadric, const glm::vec3& normal, GLfloat distance, double weight) {
+    double a = normal.x, b = normal.y, c = normal.z, d = distance;
+    quadric.a00 += weight * a * a;
+    quadric.a01 += weight * a * b;
+    quadric.a02 += weight * a * c;
+    quadric.a11 += weight * b * b;
+    quadric.a12 += weight * b * c;
+    quadric.a22 += weight * c * c;
+    quadric.b0 += weight * a * d;
+    quadric.b1 += weight * b * d;
+    quadric.b2 += weight * c * d;
+    quadric.c += weight * d * d;
+    quadric.weight += weight;
+}
+
+void MeshSimplifier::AddQuadric(Quadric& quadric, const Quadric& other) {
+    quadric.a00 += other.a00;
+    quadric.a01 += other.a01;
+    quadric.a02 += other.a02;
+    quadric.a11 += other.a11;
+    quadric.a12 += other.a12;
+    quadric.a22 += other.a22;
+    quadric.b0 += other.b0;
+    quadric.b1 += other.b1;
+    quadric.b2 += other.b2;
+    quadric.c += other.c;
+    quadric.weight += other.weight;
+}
+
+double MeshSimplifier::EvaluateQuadric(const Quadric& quadric, const glm::vec3& position) {
+    if (quadric.weight == 0.0) {
+        return 0.0;
+    }
+    double x = position.x, y = position.y, z = position.z;
+    double error = quadric.a00 * x * x + 2.0 * quadric.a01 * x * y + 2.0 * quadric.a02 * x * z
+                 + quadric.a11 * y * y + 2.0 * quadric.a12 * y * z + quadric.a22 * z * z
+                 + 2.0 * (quadric.b0 * x + quadric.b1 * y + quadric.b2 * z) + quadric.c;
+    // Средний квадрат расстояния до плоскостей, ошибка в единицах модели после извлечения корня
+    return std::max(error, 0.0) / quadric.weight;
+}
+
+bool MeshSimplifier::HasFlip(const std::vector<Vertex>& vertexes, const std::vector<GLuint>& indexes,
+                             const std::vector<GLuint>& position_remap, const std::vector<size_t>& adjacency_offsets,
+                             const std::vector<size_t>& adjacency, GLuint from_position, GLuint to_position,
+                             const glm::vec3& new_position) {
+    for (size_t adjacent = adjacency_offsets[from_position]; adjacent < adjacency_offsets[from_position + 1]; ++adjacent) {
+        size_t triangle = adjacency[adjacent];
+        glm::vec3 before[3];
+        glm::vec3 after[3];
+        bool removed = false;
+        for (size_t corner = 0; corner < 3; ++corner) {
+            GLuint position = position_remap[indexes[triangle * 3 + corner]];
+            removed = removed || position == to_position;
+            before[corner] = vertexes[position].position;
+            after[corner] = position == from_position ? new_position : before[corner];
+        }
+        if (removed) {
+            continue;
+        }
+
+        glm::vec3 normal_before = glm::cross(before[1] - before[0], before[2] - before[0]);
+        glm::vec3 normal_after = glm::cross(after[1] - after[0], after[2] - after[0]);
+        if (glm::dot(normal_before, normal_after) <= FLIP_THRESHOLD * glm::length(normal_before) * glm::length(normal_after)) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -1,98 +1,277 @@
 #include "../libs/Model.h"
+#include "../libs/BakedMesh.h"
 
 
-Mesh::Mesh(const std::vector<Vertex>& vertexes,
-           const std::vector<GLuint>& indexes,
-           const std::vector<Texture2D>& textures,
+template <typename Type>
+size_t SizeofContainer(const std::vector<Type>& container) {
+    return container.size() * sizeof(Type);
+}
+
+
+Mesh::Mesh(std::vector<Vertex> vertexes,
+           std::vector<GLuint> indexes,
+           MaterialHandle material,
            bool volume)
-    : vertexes(vertexes.begin(), vertexes.end()),
-      indexes(indexes.begin(), indexes.end()),
-      textures(textures.begin(), textures.end()),
+    : vertexes(std::move(vertexes)),
+      indexes(std::move(indexes)),
+      material(material),
+      material_reference(Material::AcquireMaterial(material)),
       volume(volume) {}
 
-void Mesh::InitializeMesh() {
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &IBO);
+Mesh::Mesh(MeshData mesh_data, MaterialHandle material, bool volume)
+    : Mesh(std::move(mesh_data.vertexes), std::move(mesh_data.indexes), material, volume) {}
 
-    glBindVertexArray(VAO);
+Mesh::Mesh(std::shared_ptr<const BakedMesh> baked_mesh, MaterialHandle material, bool volume)
+    : baked_mesh(std::move(baked_mesh)), material(material), material_reference(Material::AcquireMaterial(material)), volume(volume) {}
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, SizeofContainer(vertexes), std::data(vertexes), GL_STATIC_DRAW);
+MeshMemoryStats Mesh::memory_stats;
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, SizeofContainer(indexes), std::data(indexes), GL_STATIC_DRAW);
+void Mesh::InitializeMesh(MeshResidency new_residency, VertexPacking new_vertex_packing) {
+    if (baked_mesh) {
+        InitializeBakedMesh(new_residency);
+        return;
+    }
 
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(0));
+    if (indexes.empty()) {
+        indexes.resize(vertexes.size());
+        std::iota(indexes.begin(), indexes.end(), 0);
+    }
+    index_type = vertexes.size() <= std::numeric_limits<GLushort>::max() + size_t(1) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    vertex_packing = new_vertex_packing == VertexPacking::AUTO ? ChooseVertexPacking(vertexes) : new_vertex_packing;
+    residency = new_residency;
 
-    glEnableVertexAttribArray(1); 
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, normal)));
-    
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, texture_position)));
+    size_t source_bytes = SizeofContainer(vertexes) + SizeofContainer(indexes);
+    size_t uploaded_bytes = SizeofContainer(indexes);
+    if (vertex_packing == VertexPacking::PACKED) {
+        std::vector<PackedVertex> packed_vertexes = PackVertexes(vertexes);
+        geometry = GetArena().Allocate(std::data(packed_vertexes), packed_vertexes.size(), indexes);
+        uploaded_bytes += SizeofContainer(packed_vertexes);
+        memory_stats.packing_saved_bytes += SizeofContainer(vertexes) - SizeofContainer(packed_vertexes);
+    } else {
+        geometry = GetArena().Allocate(std::data(vertexes), vertexes.size(), indexes);
+        uploaded_bytes += SizeofContainer(vertexes);
+    }
+    uploaded_bytes += vertexes.size() * GeometryArena::POSITION_STRIDE;
+    RetainGeometry(uploaded_bytes);
+    lods.assign(1, MeshLod{ 0, static_cast<GLsizei>(indexes.size()), 0.0f });
 
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, tangent)));
+    if (!vertexes.empty()) {
+        glm::vec3 bounds_min = vertexes.front().position;
+        glm::vec3 bounds_max = vertexes.front().position;
+        for (const auto &vertex : vertexes) {
+            bounds_min = glm::min(bounds_min, vertex.position);
+            bounds_max = glm::max(bounds_max, vertex.position);
+        }
+        bounding_sphere = glm::vec4(0.5f * (bounds_min + bounds_max), 0.5f * glm::length(bounds_max - bounds_min));
+    }
 
-    glEnableVertexAttribArray(4);
-    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, bitangent)));
+    if (residency == MeshResidency::POSITIONS) {
+        positions.reserve(vertexes.size());
+        for (const auto &vertex : vertexes) {
+            positions.push_back(vertex.position);
+        }
+    }
+    if (residency != MeshResidency::RETAIN) {
+        std::vector<Vertex>().swap(vertexes);
+    }
+    if (residency == MeshResidency::DISCARD) {
+        std::vector<GLuint>().swap(indexes);
+    }
 
-    glBindVertexArray(0);
+    memory_stats.cpu_bytes += GetResidentBytes();
+    memory_stats.released_bytes += source_bytes - std::min(source_bytes, GetResidentBytes());
 }
 
-void Mesh::DrawMesh(const ShaderPipe &shader_program) {
-    int cnt_diffuse = 0;
-    int cnt_specular = 0;
-    int cnt_normal = 0;
-    int cnt_depth = 0;
+void Mesh::InitializeBakedMesh(MeshResidency new_residency) {
+    index_type = baked_mesh->GetIndexType();
+    vertex_packing = baked_mesh->GetVertexPacking();
+    residency = new_residency;
+    lods = baked_mesh->GetLods();
 
-    for (size_t idx = 0; idx < textures.size(); ++idx) {
-        std::stringstream name_texture;
+    geometry = GetArena().Allocate(baked_mesh->GetVertexData(), baked_mesh->GetVertexCount(),
+                                   baked_mesh->GetIndexData(), baked_mesh->GetIndexCount(), baked_mesh->GetPositionData());
+    RetainGeometry(baked_mesh->GetVertexCount() * (GetVertexFormat(vertex_packing).stride + GeometryArena::POSITION_STRIDE)
+                   + baked_mesh->GetIndexCount() * GeometryArena::GetIndexSize(index_type));
+    geometry.cnt_indexes = lods.front().cnt_indexes;
+    glm::vec3 bounds_min = baked_mesh->GetBoundsMin();
+    glm::vec3 bounds_max = baked_mesh->GetBoundsMax();
+    bounding_sphere = glm::vec4(0.5f * (bounds_min + bounds_max), 0.5f * glm::length(bounds_max - bounds_min));
 
-        if (textures[idx].GetType() == Texture2D::DIFFUSE_MAP) {
-            name_texture << Texture2D::DIFFUSE_MAP << "[" << cnt_diffuse++ << "]";
-        } else if (textures[idx].GetType() == Texture2D::SPECULAR_MAP) {
-            name_texture << Texture2D::SPECULAR_MAP << "[" << cnt_specular++ << "]";
-        } else if (textures[idx].GetType() == Texture2D::NORMAL_MAP) {
-            name_texture << Texture2D::NORMAL_MAP << "[" << cnt_normal++ << "]";
-        } else {
-            name_texture << Texture2D::DEPTH_MAP << "[" << cnt_depth++ << "]";
-        }
+    size_t source_bytes = baked_mesh->GetSize();
 
-        textures[idx].UseTexture(shader_program, name_texture.str(), idx);
-        name_texture << "." << Texture::TEXTURE;
-        shader_program.SetInt(name_texture.str(), idx);
+    if (residency == MeshResidency::POSITIONS) {
+        const auto *baked_positions = static_cast<const glm::vec3*>(baked_mesh->GetPositionData());
+        positions.assign(baked_positions, baked_positions + baked_mesh->GetVertexCount());
+    }
+    if (residency != MeshResidency::RETAIN) {
+        baked_mesh.reset();
     }
 
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLES, 0, vertexes.size());
-    glBindVertexArray(0);
+    memory_stats.cpu_bytes += GetResidentBytes();
+    memory_stats.released_bytes += source_bytes - std::min(source_bytes, GetResidentBytes());
+}
+
+// Копии меша делят один диапазон арены, он возвращается в арену вместе с последней копией
+void Mesh::RetainGeometry(size_t gpu_bytes) {
+    GeometryArena *arena = &GetArena();
+    memory_stats.gpu_bytes += gpu_bytes;
+    geometry_reference = std::shared_ptr<const GeometryRange>(new GeometryRange(geometry), [arena, gpu_bytes](const GeometryRange *range) {
+        arena->Free(*range);
+        memory_stats.gpu_bytes -= gpu_bytes;
+        delete range;
+    });
+}
+
+const std::vector<size_t>& Mesh::BindShaderPipe(const ShaderPipe &shader_program) const {
+    return material_reference->BindShaderPipe(shader_program);
+}
+
+void Mesh::BindMaterial(const ShaderPipe &shader_program) const {
+    material_reference->UseMaterial(shader_program);
+}
+
+void Mesh::DrawMesh(GLuint instance_buffer, GLintptr instance_offset, GLsizei cnt_instances, VertexStream vertex_stream,
+                    size_t lod) const {
+    GLState::BindVertexArray(GetArena().GetVertexArray(vertex_stream));
+    FigurePosition::BindInstanceAttribute(instance_buffer, instance_offset);
+    GetArena().DrawRange(GetLodRange(lod), cnt_instances, vertex_stream);
+}
+
+void Mesh::QueueMesh(GLsizei cnt_instances, GLuint base_instance, size_t lod) const {
+    GetArena().QueueDraw(GetLodRange(lod), cnt_instances, base_instance);
+}
+
+MaterialHandle Mesh::GetMaterial() const {
+    return material;
+}
 
-    glActiveTexture(GL_TEXTURE0);
+bool Mesh::HasSameMaterial(const Mesh &other) const {
+    return material == other.material;
 }
 
 bool Mesh::IsVolume() const {
     return volume;
 }
 
+MeshResidency Mesh::GetResidency() const {
+    return residency;
+}
 
-template <typename Type>
-size_t SizeofContainer(const std::vector<Type>& container) {
-    return container.size() * sizeof(Type);
+VertexPacking Mesh::GetVertexPacking() const {
+    return vertex_packing;
 }
 
+const std::vector<MeshLod>& Mesh::GetLods() const {
+    return lods;
+}
 
-FigurePosition::FigurePosition(glm::mat4 model, glm::mat4 view, glm::mat4 projection) 
-    : model(model), view(view), projection(projection) {}
+GeometryRange Mesh::GetLodRange(size_t lod) const {
+    if (lod == 0 || lod >= lods.size()) {
+        return geometry;
+    }
+    GeometryRange range = geometry;
+    range.first_index += lods[lod].first_index;
+    range.cnt_indexes = lods[lod].cnt_indexes;
+    return range;
+}
 
-void FigurePosition::UseFigurePosition(const ShaderPipe& shader_program) const {
-    std::stringstream name;
-    name << FIGURE_POSITION << ".";
+glm::vec4 Mesh::GetBoundingSphere() const {
+    return bounding_sphere;
+}
+
+size_t Mesh::GetResidentBytes() const {
+    return SizeofContainer(vertexes) + SizeofContainer(indexes) + SizeofContainer(positions) + (baked_mesh ? baked_mesh->GetSize() : 0);
+}
+
+GeometryArena& Mesh::GetArena() const {
+    return GetGeometryArena(vertex_packing, index_type);
+}
 
-    shader_program.SetMat4(name.str() + std::string(MODEL), model);
-    shader_program.SetMat4(name.str() + std::string(VIEW), view);
-    shader_program.SetMat4(name.str() + std::string(PROJECTION), projection);
+GeometryArena& Mesh::GetGeometryArena(VertexPacking vertex_packing, GLenum index_type) {
+    static GeometryArena short_geometry_arena(GetVertexFormat(VertexPacking::FLOAT), GL_UNSIGNED_SHORT);
+    static GeometryArena geometry_arena(GetVertexFormat(VertexPacking::FLOAT), GL_UNSIGNED_INT);
+    static GeometryArena short_packed_geometry_arena(GetVertexFormat(VertexPacking::PACKED), GL_UNSIGNED_SHORT);
+    static GeometryArena packed_geometry_arena(GetVertexFormat(VertexPacking::PACKED), GL_UNSIGNED_INT);
+    if (vertex_packing == VertexPacking::PACKED) {
+        return index_type == GL_UNSIGNED_SHORT ? short_packed_geometry_arena : packed_geometry_arena;
+    }
+    return index_type == GL_UNSIGNED_SHORT ? short_geometry_arena : geometry_arena;
+}
+
+const MeshMemoryStats& Mesh::GetMemoryStats() {
+    return memory_stats;
+}
+
+void Mesh::PrintMemoryStats() {
+    std::cout << "MESH_MEMORY::GPU " << memory_stats.gpu_bytes / 1024 << " KB, "
+              << "CPU " << memory_stats.cpu_bytes / 1024 << " KB, "
+              << "RELEASED " << memory_stats.released_bytes / 1024 << " KB, "
+              << "PACKING SAVED " << memory_stats.packing_saved_bytes / 1024 << " KB" << std::endl;
+}
+
+glm::vec3 Mesh::NormalizeDirection(const glm::vec3& direction) {
+    GLfloat length = glm::length(direction);
+    return std::isfinite(length) && length > 0.0f ? direction / length : glm::vec3(0.0f);
+}
+
+VertexPacking Mesh::ChooseVertexPacking(const std::vector<Vertex>& vertexes) {
+    auto is_snorm = [](const glm::vec3 &direction) {
+        return std::abs(direction.x) <= 1.0f && std::abs(direction.y) <= 1.0f && std::abs(direction.z) <= 1.0f;
+    };
+
+    for (const auto &vertex : vertexes) {
+        glm::vec2 texture_position = glm::unpackHalf2x16(glm::packHalf2x16(vertex.texture_position));
+        if (!(std::abs(texture_position.x - vertex.texture_position.x) <= MAX_TEXTURE_COORD_ERROR &&
+              std::abs(texture_position.y - vertex.texture_position.y) <= MAX_TEXTURE_COORD_ERROR) ||
+            !is_snorm(NormalizeDirection(vertex.normal)) || !is_snorm(NormalizeDirection(glm::vec3(vertex.tangent)))) {
+            return VertexPacking::FLOAT;
+        }
+    }
+    return VertexPacking::PACKED;
+}
+
+std::vector<PackedVertex> Mesh::PackVertexes(const std::vector<Vertex>& vertexes) {
+    std::vector<PackedVertex> packed_vertexes;
+    packed_vertexes.reserve(vertexes.size());
+    for (const auto &vertex : vertexes) {
+        GLfloat handedness = vertex.tangent.w < 0.0f ? -1.0f : 1.0f;
+        packed_vertexes.push_back({ vertex.position,
+                                    glm::packSnorm3x10_1x2(glm::vec4(NormalizeDirection(vertex.normal), 0.0f)),
+                                    glm::packSnorm3x10_1x2(glm::vec4(NormalizeDirection(glm::vec3(vertex.tangent)), handedness)),
+                                    glm::packHalf2x16(vertex.texture_position) });
+    }
+    return packed_vertexes;
+}
+
+VertexFormat Mesh::GetVertexFormat(VertexPacking vertex_packing) {
+    VertexFormat vertex_format;
+    if (vertex_packing == VertexPacking::PACKED) {
+        vertex_format = { sizeof(PackedVertex), {
+            { 0, 3, GL_FLOAT, GL_FALSE, offsetof(PackedVertex, position) },
+            { 1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, offsetof(PackedVertex, normal) },
+            { 2, 2, GL_HALF_FLOAT, GL_FALSE, offsetof(PackedVertex, texture_position) },
+            { 3, 4, GL_INT_2_10_10_10_REV, GL_TRUE, offsetof(PackedVertex, tangent) } } };
+    } else {
+        vertex_format = { sizeof(Vertex), {
+            { 0, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, position) },
+            { 1, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, normal) },
+            { 2, 2, GL_FLOAT, GL_FALSE, offsetof(Vertex, texture_position) },
+            { 3, 4, GL_FLOAT, GL_FALSE, offsetof(Vertex, tangent) } } };
+    }
+
+    for (GLuint idx = 0; idx < FigurePosition::MODEL_COLUMNS; ++idx) {
+        vertex_format.attributes.push_back({ FigurePosition::MODEL_LOCATION + idx, 4, GL_FLOAT, GL_FALSE, 0, 1 });
+    }
+    return vertex_format;
+}
+
+
+void FigurePosition::BindInstanceAttribute(GLuint instance_buffer, GLintptr instance_offset) {
+    glBindBuffer(GL_ARRAY_BUFFER, instance_buffer);
+    for (GLuint idx = 0; idx < MODEL_COLUMNS; ++idx) {
+        glVertexAttribPointer(MODEL_LOCATION + idx, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                              reinterpret_cast<void*>(instance_offset + idx * sizeof(glm::vec4)));
+    }
 }
 
 
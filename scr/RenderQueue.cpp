@@ -0,0 +1,97 @@
+﻿#include "../libs/RenderQueue.h"
+
+
+uint64_t RenderQueue::MakeSortKey(uint32_t pass, GLuint program, GLuint material, GLuint mesh, uint32_t lod,
+                                  GLfloat depth, GLfloat far_plane) {
+    GLfloat depth_normalized = far_plane > 0.0f ? depth / far_plane : 0.0f;
+    depth_normalized = depth_normalized < 0.0f ? 0.0f : (depth_normalized > 1.0f ? 1.0f : depth_normalized);
+    uint64_t depth_quantized = static_cast<uint64_t>(depth_normalized * ((uint64_t(1) << DEPTH_BITS) - 1));
+
+    uint32_t shift = 64;
+    uint64_t key = 0;
+    key |= PackField(pass, PASS_BITS, shift -= PASS_BITS);
+    key |= PackField(GetDenseIndex(program_indexes, program, PROGRAM_BITS), PROGRAM_BITS, shift -= PROGRAM_BITS);
+    key |= PackField(GetDenseIndex(material_indexes, material, MATERIAL_BITS), MATERIAL_BITS, shift -= MATERIAL_BITS);
+    key |= PackField(GetDenseIndex(mesh_indexes, mesh, MESH_BITS), MESH_BITS, shift -= MESH_BITS);
+    key |= PackField(lod, LOD_BITS, shift -= LOD_BITS);
+    key |= PackField(depth_quantized, DEPTH_BITS, shift -= DEPTH_BITS);
+    return key;
+}
+
+void RenderQueue::Clear() {
+    items.clear();
+    ++cnt_passes;
+    overflow_reported = false;
+}
+
+void RenderQueue::Push(uint64_t key, size_t object) {
+    items.push_back(DrawItem{ key, object });
+}
+
+void RenderQueue::Sort() {
+    if (items.empty()) {
+        return;
+    }
+    sorted_items.resize(items.size());
+
+    for (uint32_t shift = 0; shift < 64; shift += RADIX_BITS) {
+        size_t counts[RADIX_SIZE] = {};
+        for (const auto &item : items) {
+            ++counts[(item.key >> shift) & (RADIX_SIZE - 1)];
+        }
+
+        // Разряд совпадает у всех ключей - проход ничего не меняет
+        if (counts[(items[0].key >> shift) & (RADIX_SIZE - 1)] == items.size()) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (auto &count : counts) {
+            size_t cnt = count;
+            count = offset;
+            offset += cnt;
+        }
+
+        for (const auto &item : items) {
+            sorted_items[counts[(item.key >> shift) & (RADIX_SIZE - 1)]++] = item;
+        }
+        items.swap(sorted_items);
+    }
+}
+
+const std::vector<DrawItem>& RenderQueue::GetItems() const {
+    return items;
+}
+
+uint64_t RenderQueue::PackField(uint64_t value, uint32_t bits, uint32_t shift) {
+    return (value & ((uint64_t(1) << bits) - 1)) << shift;
+}
+
+GLuint RenderQueue::GetDenseIndex(std::unordered_map<GLuint, DenseIndex>& indexes, GLuint id, uint32_t bits) {
+    auto index = indexes.find(id);
+    if (index != indexes.end()) {
+        index->second.pass = cnt_passes;
+        return index->second.index;
+    }
+
+    size_t cnt_indexes = size_t(1) << bits;
+    if (indexes.size() < cnt_indexes) {
+        return indexes.emplace(id, DenseIndex{ static_cast<GLuint>(indexes.size()), cnt_passes }).first->second.index;
+    }
+
+    // Все номера заняты: номер, не встречавшийся в текущем проходе, можно отдать новому идентификатору,
+    // ключи уже добавленных элементов от этого не меняются
+    for (auto stale = indexes.begin(); stale != indexes.end(); ++stale) {
+        if (stale->second.pass != cnt_passes) {
+            GLuint free_index = stale->second.index;
+            indexes.erase(stale);
+            return indexes.emplace(id, DenseIndex{ free_index, cnt_passes }).first->second.index;
+        }
+    }
+
+    if (!overflow_reported) {
+        std::cerr << "ERROR::RENDER_QUEUE::SORT_KEY_FIELD_OVERFLOW " << bits << " BITS" << std::endl;
+        overflow_reported = true;
+    }
+    return static_cast<GLuint>(cnt_indexes - 1);
+}
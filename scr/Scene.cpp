@@ -10,13 +10,13 @@ ObjectCreater::ObjectCreater(const std::vector<glm::vec3>& vertexes_coordinates,
       includes_texture_coords(includes_texture_coords.begin(), includes_texture_coords.end()),
       cycle(cycle) {}
 
-std::vector<Vertex> ObjectCreater::CreateObject() const {
+MeshData ObjectCreater::CreateObject() const {
     if (includes_normals.size() != includes_vertexes_coords.size() &&
         includes_normals.size() != includes_texture_coords.size() && 
         includes_normals.size() % 3 != 0 && vertexes_coordinates.size() % 3 != 0 &&
         normals.size() % 3 != 0 && texture_coordinates.size() % 3 != 0) {
         std::cerr << "ERROR::OBJECT_CREATER::UNKNOWN_INDEXING_DATA" << std::endl;
-        return std::vector<Vertex>();
+        return MeshData();
     }
 
     std::vector<Vertex> vertexes_object;
@@ -32,7 +32,7 @@ std::vector<Vertex> ObjectCreater::CreateObject() const {
                 vertexes_coordinates[size_batch_vertex_coords * idx + includes_vertexes_coords[3 * jdx + 1]],
                 vertexes_coordinates[size_batch_vertex_coords * idx + includes_vertexes_coords[3 * jdx + 2]]
             };
-            glm::vec3 normal = normals[size_batch_norms * idx + includes_normals[jdx]];
+            glm::vec3 normal = Mesh::NormalizeDirection(normals[size_batch_norms * idx + includes_normals[jdx]]);
             std::vector<glm::vec2> cur_texture_coords {
                 texture_coordinates[size_batch_texture_coords * idx + includes_texture_coords[3 * jdx]],
                 texture_coordinates[size_batch_texture_coords * idx + includes_texture_coords[3 * jdx + 1]],
@@ -40,21 +40,54 @@ std::vector<Vertex> ObjectCreater::CreateObject() const {
             };
 
             auto [tangent, bitangent] = GetBiTangent(cur_vertex_coords, normal, cur_texture_coords);
+            tangent = Mesh::NormalizeDirection(tangent - normal * glm::dot(normal, tangent));
+            GLfloat handedness = glm::dot(glm::cross(normal, tangent), bitangent) < 0.0f ? -1.0f : 1.0f;
 
             for (size_t kdx = 0; kdx < 3; ++kdx) {
                 Vertex vertex;
                 vertex.position = cur_vertex_coords[kdx];
                 vertex.normal = normal;
                 vertex.texture_position = cur_texture_coords[kdx];
-                vertex.tangent = tangent;
-                vertex.bitangent = bitangent;
+                vertex.tangent = glm::vec4(tangent, handedness);
 
                 vertexes_object.push_back(vertex);
             }
         }
     }
 
-    return vertexes_object;
+    MeshData mesh_data = WeldVertexes(vertexes_object);
+    MeshOptimizer::OptimizeMesh(mesh_data);
+    return mesh_data;
+}
+
+MeshData ObjectCreater::WeldVertexes(const std::vector<Vertex>& vertexes) {
+    MeshData mesh_data;
+    mesh_data.indexes.reserve(vertexes.size());
+
+    std::unordered_map<Vertex, GLuint, VertexHash, VertexEqual> unique_vertexes;
+    unique_vertexes.reserve(vertexes.size());
+    for (const auto &vertex : vertexes) {
+        auto [unique_vertex, inserted] = unique_vertexes.emplace(vertex, static_cast<GLuint>(mesh_data.vertexes.size()));
+        if (inserted) {
+            mesh_data.vertexes.push_back(vertex);
+        }
+        mesh_data.indexes.push_back(unique_vertex->second);
+    }
+    return mesh_data;
+}
+
+size_t ObjectCreater::VertexHash::operator()(const Vertex& vertex) const {
+    const auto *bytes = reinterpret_cast<const unsigned char*>(&vertex);
+    size_t hash = 14695981039346656037ull;
+    for (size_t idx = 0; idx < sizeof(Vertex); ++idx) {
+        hash ^= bytes[idx];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool ObjectCreater::VertexEqual::operator()(const Vertex& lhs, const Vertex& rhs) const {
+    return std::memcmp(&lhs, &rhs, sizeof(Vertex)) == 0;
 }
 
 std::pair<glm::vec3, glm::vec3> ObjectCreater::GetBiTangent(const std::vector<glm::vec3>& vertex_coords,
@@ -15,23 +15,26 @@ std::optional <GLuint> Shader::GetShaderID() const {
 }
 
 void Shader::LoadRealizationShader(const std::string& path_shader_realization, int log_info_size = 512) {
-    std::string shader_code_realization = "";
-    std::ifstream shader_realization(path_shader_realization, std::ios::in);
-
-    if (shader_realization.is_open()) {
-        std::string line_buf = "";
-        while (std::getline(shader_realization, line_buf)) {
-            shader_code_realization += line_buf + "\n";
-        }
-        shader_realization.close();
-    } else {
+    auto shader_code_realization = ReadRealizationShader(path_shader_realization);
+    if (!shader_code_realization) {
         std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
     }
+    CompileRealizationShader(shader_code_realization.value_or(""), log_info_size);
+}
 
+void Shader::CompileRealizationShader(const std::string& shader_code_realization, int log_info_size = 512) {
+    SubmitRealizationShader(shader_code_realization);
+    CheckRealizationShader(log_info_size);
+}
+
+void Shader::SubmitRealizationShader(const std::string& shader_code_realization) {
     GLchar const * shader_source = shader_code_realization.c_str();
     shader_id = glCreateShader(type_shader);
     glShaderSource(*shader_id, 1, &shader_source, nullptr);
     glCompileShader(*shader_id);
+}
+
+bool Shader::CheckRealizationShader(int log_info_size = 512) const {
     int status;
     std::string log_info;
     log_info.resize(log_info_size);
@@ -40,8 +43,42 @@ void Shader::LoadRealizationShader(const std::string& path_shader_realization, i
         glGetShaderInfoLog(*shader_id, log_info_size, nullptr, std::data(log_info));
         std::cerr << "ERROR::SHADER::COMPILATION_FAILED\n" << log_info << std::endl;
     }
+    return status;
+}
+
+
+UniformName::UniformName(std::string_view name)
+    : handle(0) {
+    auto [name_handle, inserted] = GetHandles().emplace(std::string(name), GetNames().size());
+    if (inserted) {
+        GetNames().push_back(name_handle->first);
+    }
+    handle = name_handle->second;
 }
 
+UniformName::UniformName(std::string_view name, size_t idx)
+    : UniformName(std::string(name) + "[" + std::to_string(idx) + "]") {}
+
+size_t UniformName::GetHandle() const {
+    return handle;
+}
+
+const std::string& UniformName::GetName() const {
+    return GetNames()[handle];
+}
+
+std::unordered_map<std::string, size_t>& UniformName::GetHandles() {
+    static std::unordered_map<std::string, size_t> handles;
+    return handles;
+}
+
+std::deque<std::string>& UniformName::GetNames() {
+    static std::deque<std::string> names;
+    return names;
+}
+
+
+UniformUploadStats ShaderPipe::upload_stats;
 
 ShaderPipe::ShaderPipe() = default;
 
@@ -50,87 +87,509 @@ std::optional <GLuint> ShaderPipe::GetShaderPipeID() const {
 }
 
 void ShaderPipe::CreateShaderPipe(const std::vector<Shader> &shaders, int log_info_size = 512) {
-    shader_pipe_id = glCreateProgram();
+    LinkShaderPipe(shaders);
+    FinishShaderPipe(log_info_size);
+}
+
+void ShaderPipe::LinkShaderPipe(const std::vector<Shader> &shaders) {
+    program_handle = std::make_shared<GLProgram>(GLProgram::Create());
+    shader_pipe_id = program_handle->Get();
     for (const auto &shader : shaders) {
         auto shader_id = shader.GetShaderID();
         if (shader_id) {
             glAttachShader(*shader_pipe_id, *shader_id);
         }
     }
+    if (ShaderCache::IsSupported()) {
+        glProgramParameteri(*shader_pipe_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glLinkProgram(*shader_pipe_id);
+}
+
+bool ShaderPipe::IsShaderPipeReady() const {
+#ifdef GL_KHR_parallel_shader_compile
+    if (GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile) {
+        GLint completed = GL_TRUE;
+        glGetProgramiv(*shader_pipe_id, GL_COMPLETION_STATUS_KHR, &completed);
+        return completed;
+    }
+#endif
+    return true;
+}
 
+bool ShaderPipe::FinishShaderPipe(int log_info_size = 512) {
     int status;
     std::string log_info;
     log_info.resize(log_info_size);
     glGetProgramiv(*shader_pipe_id, GL_LINK_STATUS, &status);
     if (!status) {
-         glGetProgramInfoLog(*shader_pipe_id, 512, nullptr, std::data(log_info));
+         glGetProgramInfoLog(*shader_pipe_id, log_info_size, nullptr, std::data(log_info));
          std::cerr << "ERROR::SHADER::LINKING_FAILED\n" << log_info << std::endl;
+         return false;
+    }
+
+    ReflectShaderPipe();
+    return true;
+}
+
+bool ShaderPipe::CreateShaderPipeFromBinary(const ShaderCache::ProgramBinary& program_binary) {
+    const auto &[binary_format, binary] = program_binary;
+
+    GLProgram tmp_program = GLProgram::Create();
+    glProgramBinary(tmp_program.Get(), binary_format, std::data(binary), static_cast<GLsizei>(binary.size()));
+
+    int status;
+    glGetProgramiv(tmp_program.Get(), GL_LINK_STATUS, &status);
+    if (!status) {
+        return false;
     }
+
+    program_handle = std::make_shared<GLProgram>(std::move(tmp_program));
+    shader_pipe_id = program_handle->Get();
+    ReflectShaderPipe();
+    return true;
+}
+
+std::optional<ShaderCache::ProgramBinary> ShaderPipe::GetShaderPipeBinary() const {
+    GLint binary_size = 0;
+    glGetProgramiv(*shader_pipe_id, GL_PROGRAM_BINARY_LENGTH, &binary_size);
+    if (binary_size <= 0) {
+        return std::nullopt;
+    }
+
+    GLenum binary_format = 0;
+    std::vector<GLchar> binary(binary_size);
+    glGetProgramBinary(*shader_pipe_id, binary_size, nullptr, &binary_format, std::data(binary));
+    return ShaderCache::ProgramBinary{ binary_format, std::move(binary) };
+}
+
+void ShaderPipe::ReflectShaderPipe() {
+    uniform_state->parameters.clear();
+    uniform_state->slots.clear();
+    uniform_state->handle_slots.clear();
+    uniform_state->values.clear();
+
+    GLint cnt_uniforms = 0, max_name_length = 0;
+    glGetProgramiv(*shader_pipe_id, GL_ACTIVE_UNIFORMS, &cnt_uniforms);
+    glGetProgramiv(*shader_pipe_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_name_length);
+
+    std::string name_uniform_var(max_name_length, '\0');
+    for (GLint idx = 0; idx < cnt_uniforms; ++idx) {
+        GLuint uniform_idx = idx;
+        GLint block_idx = -1;
+        glGetActiveUniformsiv(*shader_pipe_id, 1, &uniform_idx, GL_UNIFORM_BLOCK_INDEX, &block_idx);
+        if (block_idx >= 0) {
+            continue;
+        }
+
+        GLsizei name_length = 0;
+        GLint size_uniform_var = 0;
+        GLenum type_uniform_var = 0;
+        glGetActiveUniform(*shader_pipe_id, idx, max_name_length, &name_length,
+                           &size_uniform_var, &type_uniform_var, std::data(name_uniform_var));
+
+        std::string name(name_uniform_var.data(), name_length);
+        std::string name_array = name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0 ?
+                                 name.substr(0, name.size() - 3) : name;
+
+        for (GLint jdx = 0; jdx < size_uniform_var; ++jdx) {
+            ShaderParameter parameter;
+            parameter.name = size_uniform_var > 1 ? name_array + "[" + std::to_string(jdx) + "]" : name;
+            parameter.type = type_uniform_var;
+            parameter.location = glGetUniformLocation(*shader_pipe_id, parameter.name.c_str());
+            parameter.sampler = IsSamplerType(type_uniform_var);
+
+            uniform_state->slots[parameter.name] = uniform_state->parameters.size();
+            if (jdx == 0 && name_array != parameter.name) {
+                uniform_state->slots[name_array] = uniform_state->parameters.size();
+            }
+            uniform_state->parameters.push_back(std::move(parameter));
+        }
+    }
+
+    ReflectUniformBlocks();
+}
+
+void ShaderPipe::ReflectUniformBlocks() {
+    uniform_state->blocks.clear();
+
+    GLint cnt_blocks = 0, max_name_length = 0;
+    glGetProgramiv(*shader_pipe_id, GL_ACTIVE_UNIFORM_BLOCKS, &cnt_blocks);
+    glGetProgramiv(*shader_pipe_id, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &max_name_length);
+
+    std::string name_block(max_name_length, '\0');
+    for (GLint idx = 0; idx < cnt_blocks; ++idx) {
+        GLsizei name_length = 0;
+        glGetActiveUniformBlockName(*shader_pipe_id, idx, max_name_length, &name_length, std::data(name_block));
+
+        ShaderBlock block;
+        block.name = std::string(name_block.data(), name_length);
+        block.index = idx;
+        glGetActiveUniformBlockiv(*shader_pipe_id, idx, GL_UNIFORM_BLOCK_DATA_SIZE, &block.size);
+
+        block.binding = UniformBuffer::GetBindingPoint(block.name);
+        if (block.binding) {
+            glUniformBlockBinding(*shader_pipe_id, idx, *block.binding);
+        } else {
+            std::cerr << "ERROR::SHADER::UNKNOWN_UNIFORM_BLOCK" << std::endl;
+        }
+        uniform_state->blocks.push_back(std::move(block));
+    }
+}
+
+bool ShaderPipe::IsSamplerType(GLenum type_uniform_var) {
+    switch (type_uniform_var) {
+    case GL_SAMPLER_1D:
+    case GL_SAMPLER_2D:
+    case GL_SAMPLER_3D:
+    case GL_SAMPLER_CUBE:
+    case GL_SAMPLER_1D_SHADOW:
+    case GL_SAMPLER_2D_SHADOW:
+    case GL_SAMPLER_CUBE_SHADOW:
+    case GL_SAMPLER_1D_ARRAY:
+    case GL_SAMPLER_2D_ARRAY:
+    case GL_SAMPLER_2D_MULTISAMPLE:
+    case GL_SAMPLER_BUFFER:
+    case GL_INT_SAMPLER_2D:
+    case GL_UNSIGNED_INT_SAMPLER_2D:
+        return true;
+    default:
+        return false;
+    }
+}
+
+UniformLocation ShaderPipe::GetLocation(const std::string &name_uniform_var) const {
+    auto slot = GetSlot(name_uniform_var);
+    return slot ? uniform_state->parameters[*slot].location : -1;
+}
+
+UniformLocation ShaderPipe::GetLocation(const UniformName &name_uniform_var) const {
+    auto slot = GetSlot(name_uniform_var);
+    return slot ? uniform_state->parameters[*slot].location : -1;
+}
+
+std::optional<size_t> ShaderPipe::GetSlot(const std::string &name_uniform_var) const {
+    auto slot = uniform_state->slots.find(name_uniform_var);
+    if (slot == uniform_state->slots.end()) {
+        return std::nullopt;
+    }
+    return slot->second;
+}
+
+std::optional<size_t> ShaderPipe::GetSlot(const UniformName &name_uniform_var) const {
+    auto &handle_slots = uniform_state->handle_slots;
+    if (name_uniform_var.GetHandle() >= handle_slots.size()) {
+        handle_slots.resize(name_uniform_var.GetHandle() + 1);
+    }
+
+    auto &slot = handle_slots[name_uniform_var.GetHandle()];
+    if (!slot) {
+        slot = GetSlot(name_uniform_var.GetName()).value_or(MISSING_SLOT);
+    }
+    if (*slot == MISSING_SLOT) {
+        return std::nullopt;
+    }
+    return *slot;
+}
+
+bool ShaderPipe::HasParameter(const UniformName &name_uniform_var) const {
+    return GetSlot(name_uniform_var).has_value();
+}
+
+const ShaderParameter& ShaderPipe::GetParameter(size_t slot) const {
+    return uniform_state->parameters[slot];
 }
 
-GLint ShaderPipe::GetLocation(const std::string &name_uniform_var) const {
-    return glGetUniformLocation(*shader_pipe_id, name_uniform_var.c_str());
+const std::vector<ShaderParameter>& ShaderPipe::GetParameters() const {
+    return uniform_state->parameters;
+}
+
+const std::vector<ShaderBlock>& ShaderPipe::GetBlocks() const {
+    return uniform_state->blocks;
 }
 
 void ShaderPipe::UseShaderPipe() const {
-    glUseProgram(*shader_pipe_id);
+    GLState::UseProgram(*shader_pipe_id);
 }
 
 void ShaderPipe::SetInt(const std::string& var_key, GLint var_val) const {
-    auto a = glGetUniformLocation(*shader_pipe_id, var_key.c_str());
-    glUniform1i(glGetUniformLocation(*shader_pipe_id, var_key.c_str()), var_val);
+    SetInt(GetLocation(var_key), var_val);
 }
 
 void ShaderPipe::SetFloat(const std::string& var_key, GLfloat var_val) const {
-    glUniform1f(glGetUniformLocation(*shader_pipe_id, var_key.c_str()), var_val);
+    SetFloat(GetLocation(var_key), var_val);
 }
 
 void ShaderPipe::SetVec2(const std::string& var_key, const glm::vec2& var_val) const {
-    glUniform2fv(glGetUniformLocation(*shader_pipe_id, var_key.c_str()), 1, glm::value_ptr(var_val));
+    SetVec2(GetLocation(var_key), var_val);
 }
 
 void ShaderPipe::SetVec3(const std::string& var_key, const glm::vec3& var_val) const {
-    glUniform3fv(glGetUniformLocation(*shader_pipe_id, var_key.c_str()), 1, glm::value_ptr(var_val));
+    SetVec3(GetLocation(var_key), var_val);
 }
 
 void ShaderPipe::SetVec4(const std::string& var_key, const glm::vec4& var_val) const {
-    glUniform4fv(glGetUniformLocation(*shader_pipe_id, var_key.c_str()), 1, glm::value_ptr(var_val));
+    SetVec4(GetLocation(var_key), var_val);
 }
 
 void ShaderPipe::SetMat2(const std::string& var_key, const glm::mat2& var_val) const {
-    glUniformMatrix2fv(glGetUniformLocation(*shader_pipe_id, var_key.c_str()), 1, GL_FALSE, glm::value_ptr(var_val));
+    SetMat2(GetLocation(var_key), var_val);
 }
 
 void ShaderPipe::SetMat3(const std::string& var_key, const glm::mat3& var_val) const {
-    glUniformMatrix3fv(glGetUniformLocation(*shader_pipe_id, var_key.c_str()), 1, GL_FALSE, glm::value_ptr(var_val));
+    SetMat3(GetLocation(var_key), var_val);
 }
 
 void ShaderPipe::SetMat4(const std::string& var_key, const glm::mat4& var_val) const {
-    glUniformMatrix4fv(glGetUniformLocation(*shader_pipe_id, var_key.c_str()), 1, GL_FALSE, glm::value_ptr(var_val));
+    SetMat4(GetLocation(var_key), var_val);
 }
 
+void ShaderPipe::SetInt(UniformLocation location, GLint var_val) const {
+    if (IsUniformChanged(location, &var_val, sizeof(var_val))) {
+        glUniform1i(location, var_val);
+    }
+}
 
-ShaderLoadInfo::ShaderLoadInfo(const std::string &file_shader_path, const GLenum type_shader)
-    : file_shader_path(file_shader_path), type_shader(type_shader) {}
+void ShaderPipe::SetFloat(UniformLocation location, GLfloat var_val) const {
+    if (IsUniformChanged(location, &var_val, sizeof(var_val))) {
+        glUniform1f(location, var_val);
+    }
+}
 
+void ShaderPipe::SetVec2(UniformLocation location, const glm::vec2& var_val) const {
+    if (IsUniformChanged(location, glm::value_ptr(var_val), sizeof(var_val))) {
+        glUniform2fv(location, 1, glm::value_ptr(var_val));
+    }
+}
 
+void ShaderPipe::SetVec3(UniformLocation location, const glm::vec3& var_val) const {
+    if (IsUniformChanged(location, glm::value_ptr(var_val), sizeof(var_val))) {
+        glUniform3fv(location, 1, glm::value_ptr(var_val));
+    }
+}
+
+void ShaderPipe::SetVec4(UniformLocation location, const glm::vec4& var_val) const {
+    if (IsUniformChanged(location, glm::value_ptr(var_val), sizeof(var_val))) {
+        glUniform4fv(location, 1, glm::value_ptr(var_val));
+    }
+}
+
+void ShaderPipe::SetMat2(UniformLocation location, const glm::mat2& var_val) const {
+    if (IsUniformChanged(location, glm::value_ptr(var_val), sizeof(var_val))) {
+        glUniformMatrix2fv(location, 1, GL_FALSE, glm::value_ptr(var_val));
+    }
+}
+
+void ShaderPipe::SetMat3(UniformLocation location, const glm::mat3& var_val) const {
+    if (IsUniformChanged(location, glm::value_ptr(var_val), sizeof(var_val))) {
+        glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(var_val));
+    }
+}
+
+void ShaderPipe::SetMat4(UniformLocation location, const glm::mat4& var_val) const {
+    if (IsUniformChanged(location, glm::value_ptr(var_val), sizeof(var_val))) {
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(var_val));
+    }
+}
+
+bool ShaderPipe::IsUniformChanged(UniformLocation location, const void *var_val, size_t size) const {
+    if (location < 0) {
+        ++upload_stats.missing;
+        return false;
+    }
+
+    auto &value = uniform_state->values[location];
+    if (value.size == size && std::memcmp(value.data.data(), var_val, size) == 0) {
+        ++upload_stats.skipped;
+        return false;
+    }
+
+    value.size = size;
+    std::memcpy(value.data.data(), var_val, size);
+    ++upload_stats.uploaded;
+    return true;
+}
+
+const UniformUploadStats& ShaderPipe::GetUploadStats() {
+    return upload_stats;
+}
+
+void ShaderPipe::ResetUploadStats() {
+    upload_stats = UniformUploadStats();
+}
+
+
+ShaderLoadInfo::ShaderLoadInfo(const std::string &file_shader_path, const GLenum type_shader, const ShaderDefines &defines)
+    : file_shader_path(file_shader_path), type_shader(type_shader), defines(defines) {}
+
+
+
+std::optional<std::string> ReadRealizationShader(const std::string &path_shader_realization) {
+    std::ifstream shader_realization(path_shader_realization, std::ios::in | std::ios::binary);
+    if (!shader_realization.is_open()) {
+        return std::nullopt;
+    }
+    return std::string(std::istreambuf_iterator<char>(shader_realization), std::istreambuf_iterator<char>());
+}
+
+std::string InjectShaderDefines(const std::string &shader_code_realization, const ShaderDefines &defines) {
+    if (defines.empty()) {
+        return shader_code_realization;
+    }
+
+    size_t insert_position = 0;
+    size_t version_position = shader_code_realization.find("#version");
+    if (version_position != std::string::npos) {
+        insert_position = shader_code_realization.find('\n', version_position);
+        insert_position = insert_position == std::string::npos ? shader_code_realization.size() : insert_position + 1;
+    }
+    auto next_line = std::count(shader_code_realization.begin(), shader_code_realization.begin() + insert_position, '\n') + 1;
+
+    std::string defines_code;
+    for (const auto &[name, value] : defines) {
+        defines_code += "#define " + name + " " + value + "\n";
+    }
+    defines_code += "#line " + std::to_string(next_line) + "\n";
+
+    std::string shader_code_injected = shader_code_realization;
+    if (insert_position == shader_code_injected.size() && !shader_code_injected.empty() && shader_code_injected.back() != '\n') {
+        shader_code_injected += "\n";
+        insert_position = shader_code_injected.size();
+    }
+    return shader_code_injected.insert(insert_position, defines_code);
+}
+
+
+std::unordered_map<std::string, ShaderPipe> ShaderCompiler::shader_variants;
+
+ShaderCompiler::ShaderCompiler() {
+    EnableParallelCompile();
+}
+
+ShaderCompiler::~ShaderCompiler() {
+    Finish();
+}
+
+ShaderPipe ShaderCompiler::SubmitShaderProgram(std::vector<ShaderLoadInfo>::const_iterator info_begin,
+                                               std::vector<ShaderLoadInfo>::const_iterator info_end,
+                                               const ShaderDefines &program_defines) {
+    std::string variant_key = GetVariantKey(info_begin, info_end, program_defines);
+    auto variant = shader_variants.find(variant_key);
+    if (variant != shader_variants.end()) {
+        return variant->second;
+    }
+
+    PendingProgram pending;
+    pending.variant_key = variant_key;
+    pending.start_time = std::chrono::steady_clock::now();
 
-ShaderPipe CreateShaderProgram(std::vector<ShaderLoadInfo>::const_iterator info_begin,
-                               std::vector<ShaderLoadInfo>::const_iterator info_end) {
-    std::vector<Shader> shaders;
     std::for_each(info_begin, 
                   info_end, 
-                  [&shaders](const auto& shader_info) {
-                      Shader shader(shader_info.type_shader);
-                      shader.LoadRealizationShader(shader_info.file_shader_path);
-                      shaders.push_back(shader); 
+                  [&pending, &program_defines](const auto& shader_info) {
+                      auto shader_code_realization = ReadRealizationShader(shader_info.file_shader_path);
+                      if (!shader_code_realization) {
+                          std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
+                      }
+                      ShaderDefines defines = shader_info.defines;
+                      defines.insert(program_defines.begin(), program_defines.end());
+                      pending.sources.emplace_back(shader_info.type_shader, 
+                                                   InjectShaderDefines(shader_code_realization.value_or(""), defines));
+                  });
+
+    pending.cache_supported = ShaderCache::IsSupported();
+    if (pending.cache_supported) {
+        pending.cache_key = ShaderCache::ComputeKey(pending.sources);
+        auto program_binary = ShaderCache::LoadProgramBinary(pending.cache_key);
+        if (program_binary) {
+            if (pending.shader_program.CreateShaderPipeFromBinary(*program_binary)) {
+                ShaderCache::AddHit(std::chrono::steady_clock::now() - pending.start_time);
+                shader_variants.emplace(variant_key, pending.shader_program);
+                return pending.shader_program;
+            }
+            pending.cache_rejected = true;
+            ShaderCache::RemoveProgramBinary(pending.cache_key);
+        }
+    }
+
+    for (const auto &[type_shader, source] : pending.sources) {
+        Shader shader(type_shader);
+        shader.SubmitRealizationShader(source);
+        pending.shaders.push_back(shader);
+    }
+    pending.shader_program.LinkShaderPipe(pending.shaders);
+
+    shader_variants.emplace(variant_key, pending.shader_program);
+    pending_programs.push_back(pending);
+    return pending.shader_program;
+}
+
+bool ShaderCompiler::IsReady() const {
+    return std::all_of(pending_programs.begin(), 
+                       pending_programs.end(), 
+                       [](const auto &pending) { return pending.shader_program.IsShaderPipeReady(); });
+}
+
+bool ShaderCompiler::Finish() {
+    bool linked = true;
+    for (auto &pending : pending_programs) {
+        if (!pending.shader_program.FinishShaderPipe(512)) {
+            std::for_each(pending.shaders.begin(), pending.shaders.end(), [](const auto &shader) { shader.CheckRealizationShader(512); });
+            shader_variants.erase(pending.variant_key);
+            linked = false;
+        } else if (pending.cache_supported) {
+            auto program_binary = pending.shader_program.GetShaderPipeBinary();
+            if (program_binary) {
+                ShaderCache::SaveProgramBinary(pending.cache_key, *program_binary);
+            }
+        }
+        std::for_each(pending.shaders.begin(), pending.shaders.end(), [](auto &shader) { shader.DeleteShader(); });
+
+        ShaderCache::AddMiss(std::chrono::steady_clock::now() - pending.start_time, pending.cache_rejected);
+    }
+    pending_programs.clear();
+    return linked;
+}
+
+std::string ShaderCompiler::GetVariantKey(std::vector<ShaderLoadInfo>::const_iterator info_begin,
+                                          std::vector<ShaderLoadInfo>::const_iterator info_end,
+                                          const ShaderDefines &program_defines) {
+    std::string variant_key;
+    for (const auto &[name, value] : program_defines) {
+        variant_key += name + "=" + value + ";";
+    }
+    std::for_each(info_begin,
+                  info_end,
+                  [&variant_key](const auto& shader_info) {
+                      variant_key += "|" + std::to_string(shader_info.type_shader) + ":" + shader_info.file_shader_path + ";";
+                      for (const auto &[name, value] : shader_info.defines) {
+                          variant_key += name + "=" + value + ";";
+                      }
                   });
+    return variant_key;
+}
 
-    ShaderPipe shader_program;
-    shader_program.CreateShaderPipe(shaders);
+void ShaderCompiler::EnableParallelCompile() {
+    static bool enabled = false;
+    if (enabled) {
+        return;
+    }
+    enabled = true;
 
-    std::for_each(shaders.begin(), shaders.end(), [](auto &shader) { shader.DeleteShader(); });
+#ifdef GL_KHR_parallel_shader_compile
+    if (GLAD_GL_KHR_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    } else if (GLAD_GL_ARB_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+    }
+#endif
+}
 
+
+ShaderPipe CreateShaderProgram(std::vector<ShaderLoadInfo>::const_iterator info_begin,
+                               std::vector<ShaderLoadInfo>::const_iterator info_end,
+                               const ShaderDefines &program_defines) {
+    ShaderCompiler shader_compiler;
+    ShaderPipe shader_program = shader_compiler.SubmitShaderProgram(info_begin, info_end, program_defines);
+    shader_compiler.Finish();
     return shader_program;
 }
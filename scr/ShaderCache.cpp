@@ -0,0 +1,138 @@
+#include "../libs/ShaderCache.h"
+
+
+ShaderCacheStats ShaderCache::stats;
+
+bool ShaderCache::IsSupported() {
+    if (!GLAD_GL_VERSION_4_1 && !GLAD_GL_ARB_get_program_binary) {
+        return false;
+    }
+    GLint cnt_formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &cnt_formats);
+    return cnt_formats > 0;
+}
+
+uint64_t ShaderCache::ComputeKey(const std::vector<std::pair<GLenum, std::string>>& sources) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    auto hash_bytes = [&hash](const void *data, size_t size) {
+        const auto *bytes = static_cast<const unsigned char*>(data);
+        for (size_t idx = 0; idx < size; ++idx) {
+            hash ^= bytes[idx];
+            hash *= FNV_PRIME;
+        }
+    };
+
+    for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+        const GLubyte *driver_string = glGetString(name);
+        if (driver_string) {
+            hash_bytes(driver_string, std::char_traits<char>::length(reinterpret_cast<const char*>(driver_string)));
+        }
+    }
+
+    for (const auto &[type_shader, source] : sources) {
+        hash_bytes(&type_shader, sizeof(type_shader));
+        hash_bytes(source.data(), source.size());
+    }
+
+    return hash;
+}
+
+std::optional<ShaderCache::ProgramBinary> ShaderCache::LoadProgramBinary(uint64_t key) {
+    std::ifstream cache_file(GetCachePath(key), std::ios::in | std::ios::binary);
+    if (!cache_file.is_open()) {
+        return std::nullopt;
+    }
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t file_key = 0;
+    GLenum binary_format = 0;
+    uint64_t binary_size = 0;
+    cache_file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    cache_file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    cache_file.read(reinterpret_cast<char*>(&file_key), sizeof(file_key));
+    cache_file.read(reinterpret_cast<char*>(&binary_format), sizeof(binary_format));
+    cache_file.read(reinterpret_cast<char*>(&binary_size), sizeof(binary_size));
+    if (!cache_file || magic != CACHE_MAGIC || version != CACHE_VERSION || file_key != key) {
+        return std::nullopt;
+    }
+
+    // Размер из файла не должен превышать остаток файла, иначе запись повреждена
+    std::streampos binary_begin = cache_file.tellg();
+    cache_file.seekg(0, std::ios::end);
+    std::streampos file_end = cache_file.tellg();
+    cache_file.seekg(binary_begin);
+    if (!cache_file || binary_begin < 0 || file_end < binary_begin ||
+        binary_size != static_cast<uint64_t>(file_end - binary_begin)) {
+        return std::nullopt;
+    }
+
+    std::vector<GLchar> binary(binary_size);
+    cache_file.read(std::data(binary), binary_size);
+    if (!cache_file) {
+        return std::nullopt;
+    }
+
+    return ProgramBinary{ binary_format, std::move(binary) };
+}
+
+void ShaderCache::SaveProgramBinary(uint64_t key, const ProgramBinary& program_binary) {
+    std::error_code error;
+    std::filesystem::create_directories(std::string(CACHE_DIRECTORY), error);
+    if (error) {
+        std::cerr << "ERROR::SHADER_CACHE::DIRECTORY_NOT_CREATED" << std::endl;
+        return;
+    }
+
+    std::ofstream cache_file(GetCachePath(key), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!cache_file.is_open()) {
+        std::cerr << "ERROR::SHADER_CACHE::FILE_NOT_SUCCESFULLY_WRITTEN" << std::endl;
+        return;
+    }
+
+    const auto &[binary_format, binary] = program_binary;
+    uint64_t binary_size = binary.size();
+    cache_file.write(reinterpret_cast<const char*>(&CACHE_MAGIC), sizeof(CACHE_MAGIC));
+    cache_file.write(reinterpret_cast<const char*>(&CACHE_VERSION), sizeof(CACHE_VERSION));
+    cache_file.write(reinterpret_cast<const char*>(&key), sizeof(key));
+    cache_file.write(reinterpret_cast<const char*>(&binary_format), sizeof(binary_format));
+    cache_file.write(reinterpret_cast<const char*>(&binary_size), sizeof(binary_size));
+    cache_file.write(std::data(binary), binary.size());
+}
+
+void ShaderCache::RemoveProgramBinary(uint64_t key) {
+    std::error_code error;
+    std::filesystem::remove(GetCachePath(key), error);
+}
+
+void ShaderCache::AddHit(std::chrono::duration<double, std::milli> load_time) {
+    ++stats.hits;
+    stats.hits_time += load_time;
+}
+
+void ShaderCache::AddMiss(std::chrono::duration<double, std::milli> compile_time, bool rejected) {
+    ++stats.misses;
+    if (rejected) {
+        ++stats.rejected;
+    }
+    stats.misses_time += compile_time;
+}
+
+const ShaderCacheStats& ShaderCache::GetStats() {
+    return stats;
+}
+
+void ShaderCache::PrintStats() {
+    std::cout << "SHADER_CACHE::HITS " << stats.hits << " (" << stats.hits_time.count() << " ms)" << std::endl;
+    std::cout << "SHADER_CACHE::MISSES " << stats.misses << " (" << stats.misses_time.count() << " ms), "
+              << "REJECTED " << stats.rejected << std::endl;
+}
+
+std::filesystem::path ShaderCache::GetCachePath(uint64_t key) {
+    static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+    std::string name_file(16, '0');
+    for (size_t idx = 0; idx < name_file.size(); ++idx) {
+        name_file[name_file.size() - 1 - idx] = HEX_DIGITS[(key >> (4 * idx)) & 0xF];
+    }
+    return std::filesystem::path(std::string(CACHE_DIRECTORY)) / (name_file + ".bin");
+}
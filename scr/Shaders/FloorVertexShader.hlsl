@@ -2,8 +2,7 @@
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNorm;
 layout(location = 2) in vec2 aTexCoords;
-layout(location = 3) in vec3 aTangent;
-layout(location = 4) in vec3 aBitangent;
+layout(location = 3) in vec4 aTangent;
 
 
 out FigureParam{
@@ -17,25 +16,31 @@ out FigureParam{
 
 struct FigurePosition {
     mat4 model;
-    mat4 view;
-    mat4 projection;
 };
 
 
 
-uniform FigurePosition figure_position;
-uniform mat4 light_space;
+layout(location = 5) in mat4 aModel;
+
+layout(std140) uniform CameraParam {
+    mat4 view;
+    mat4 projection;
+    mat4 light_space;
+    vec3 view_position;
+};
 
 
 void main() {
-    gl_Position = figure_position.projection * figure_position.view * figure_position.model * vec4(aPos, 1.0);
+    FigurePosition figure_position = FigurePosition(aModel);
+
+    gl_Position = projection * view * figure_position.model * vec4(aPos, 1.0);
 
     figure_param.FragPos = vec3(figure_position.model * vec4(aPos, 1.0));
 
     vec3 N = normalize(vec3(figure_position.model * vec4(aNorm, 0.0)));
-    vec3 T = normalize(vec3(figure_position.model * vec4(aTangent, 0.0)));
+    vec3 T = normalize(vec3(figure_position.model * vec4(aTangent.xyz, 0.0)));
     T = normalize(T - dot(T, N) * N);
-    vec3 B = cross(N, T);
+    vec3 B = cross(N, T) * (aTangent.w < 0.0 ? -1.0 : 1.0);
     figure_param.TBNMatrix = mat3(T, B, N);
 
     figure_param.Normal = aNorm;
@@ -6,13 +6,20 @@ layout(location = 2) in vec2 aTexCoord;
 
 struct FigurePosition {
     mat4 model;
+};
+
+layout(location = 5) in mat4 aModel;
+
+layout(std140) uniform CameraParam {
     mat4 view;
     mat4 projection;
+    mat4 light_space;
+    vec3 view_position;
 };
 
-uniform FigurePosition figure_position;
-
 
 void main() {
-	gl_Position = figure_position.projection * figure_position.view * figure_position.model * vec4(aPos, 1.0);
+	FigurePosition figure_position = FigurePosition(aModel);
+
+	gl_Position = projection * view * figure_position.model * vec4(aPos, 1.0);
 }
\ No newline at end of file
@@ -20,44 +20,82 @@ struct Texture {
 
 struct Light {
     vec3 position;
+    float attenuation_const;
 
     vec3 direction;
+    float attenuation_lin;
 
     vec3 ambient;
+    float attenuation_quad;
     vec3 diffuse;
     vec3 specular;
-
-    float attenuation_const;
-    float attenuation_lin;
-    float attenuation_quad;
 };
 
 
+#ifndef CNT_DIFFUSE_MAP
 #define CNT_DIFFUSE_MAP 1
+#endif
+#if CNT_DIFFUSE_MAP < 1
+#error CNT_DIFFUSE_MAP must be at least 1: diffuse map is the base color of the material
+#endif
 uniform Texture diffuse_map[CNT_DIFFUSE_MAP];
 
+#ifndef CNT_SPECULAR_MAP
 #define CNT_SPECULAR_MAP 1
+#endif
+//         
+#if CNT_SPECULAR_MAP > 0
 uniform Texture specular_map[CNT_SPECULAR_MAP];
+#define SPECULAR_MAP specular_map[0]
+#else
+#define SPECULAR_MAP diffuse_map[0]
+#endif
 
+#ifndef CNT_DEPTH_MAP
 #define CNT_DEPTH_MAP 1
+#endif
+#if CNT_DEPTH_MAP > 0
 uniform Texture depth_map[CNT_DEPTH_MAP];
+#endif
 
+#ifndef CNT_NORMAL_MAP
 #define CNT_NORMAL_MAP 1
+#endif
+#if CNT_NORMAL_MAP > 0
 uniform Texture normal_map[CNT_NORMAL_MAP];
+#endif
 
+#ifndef CNT_SHADOW_MAP
 #define CNT_SHADOW_MAP 1
+#endif
 uniform sampler2D shadow_map[CNT_SHADOW_MAP];
 
+#ifndef CNT_SHADOW_CUBE_MAP
 #define CNT_SHADOW_CUBE_MAP 1
+#endif
 uniform samplerCube shadow_cube_map;
-uniform float far_plane;
 
-uniform Light light_directed;
+layout(std140) uniform CameraParam {
+    mat4 view;
+    mat4 projection;
+    mat4 light_space;
+    vec3 view_position;
+};
 
-#define CNT_LIGHT_POINT  1
-uniform Light light_point[CNT_LIGHT_POINT];
+layout(std140) uniform LightDirectedParam {
+    Light light_directed;
+};
 
-uniform vec3 view_position;
+#ifndef CNT_LIGHT_POINT
+#define CNT_LIGHT_POINT 1
+#endif
+#if CNT_LIGHT_POINT < 1
+#error CNT_LIGHT_POINT must be at least 1: light_point cannot be an empty array
+#endif
+layout(std140) uniform LightPointParam {
+    float far_plane;
+    Light light_point[CNT_LIGHT_POINT];
+};
 
 
 float ShadowCoefficientDirected(sampler2D shadow_map, vec3 normal, vec3 position) {
@@ -211,14 +249,22 @@ vec2 ParallaxMaping(vec2 tex_coords, Texture depth_map) {
 
 
 void main() {
+#if CNT_DEPTH_MAP > 0
     vec2 TexCoords = ParallaxMaping(figure_param.TexCoords, depth_map[0]);
+#else
+    vec2 TexCoords = figure_param.TexCoords;
+#endif
 
     //      
+#if CNT_NORMAL_MAP > 0
     vec3 normal = texture(normal_map[0].texture_data, TexCoords).rgb;
     normal = normal * 2.0 - 1.0;
+#else
+    vec3 normal = vec3(0.0, 0.0, 1.0);
+#endif
 
     float shadow_directed = ShadowCoefficientDirected(shadow_map[0], normal, -light_directed.position);
-    FragColor = vec4(PhongLuminousFluxDirected(diffuse_map[0], specular_map[0], TexCoords, normal, light_directed, shadow_directed), 1.0);
+    FragColor = vec4(PhongLuminousFluxDirected(diffuse_map[0], SPECULAR_MAP, TexCoords, normal, light_directed, shadow_directed), 1.0);
 
     //float shadow_point = 0;
     //FragColor = vec4(PhongLuminousFluxPoint(diffuse_map[0], specular_map[0], normal, light_point[0], shadow_point), 1.0);
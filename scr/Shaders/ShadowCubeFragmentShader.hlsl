@@ -0,0 +1,10 @@
+#version 330 core
+in vec3 FragPos;
+
+uniform vec3 light_position;
+uniform float far_plane;
+
+
+void main() {
+    gl_FragDepth = length(FragPos - light_position) / far_plane;
+}
\ No newline at end of file
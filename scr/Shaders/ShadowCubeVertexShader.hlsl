@@ -0,0 +1,21 @@
+#version 330 core
+layout(location = 0) in vec3 aPos;
+
+struct FigurePosition {
+    mat4 model;
+};
+
+layout(location = 5) in mat4 aModel;
+
+uniform mat4 shadow_view;
+
+out vec3 FragPos;
+
+
+void main() {
+    FigurePosition figure_position = FigurePosition(aModel);
+
+    vec4 world_position = figure_position.model * vec4(aPos, 1.0);
+    FragPos = world_position.xyz;
+    gl_Position = shadow_view * world_position;
+}
\ No newline at end of file
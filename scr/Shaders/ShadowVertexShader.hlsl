@@ -3,14 +3,20 @@ layout(location = 0) in vec3 aPos;
 
 struct FigurePosition {
     mat4 model;
+};
+
+layout(location = 5) in mat4 aModel;
+
+layout(std140) uniform CameraParam {
     mat4 view;
     mat4 projection;
+    mat4 light_space;
+    vec3 view_position;
 };
 
-uniform FigurePosition figure_position;
-uniform mat4 light_space;
-
 
 void main() {
+    FigurePosition figure_position = FigurePosition(aModel);
+
     gl_Position = light_space * figure_position.model * vec4(aPos, 1.0);
 }
\ No newline at end of file
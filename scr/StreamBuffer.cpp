@@ -0,0 +1,144 @@
+﻿#include "../libs/StreamBuffer.h"
+
+
+StreamBuffer::~StreamBuffer() {
+    if (!GLResourceRegistry::IsContextAlive()) {
+        return;
+    }
+    for (auto &fence : frame_fences) {
+        if (fence) {
+            glDeleteSync(fence);
+        }
+    }
+    ReleaseStorage();
+}
+
+void StreamBuffer::CreateStreamBuffer(GLsizeiptr size) {
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    uniform_alignment = std::max<GLsizeiptr>(alignment, 1);
+    persistent = GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage;
+
+    AllocateStorage(size);
+}
+
+std::optional<GLuint> StreamBuffer::GetStreamBufferID() const {
+    if (!stream_buffer) {
+        return std::nullopt;
+    }
+    return stream_buffer.Get();
+}
+
+GLsizeiptr StreamBuffer::GetUniformAlignment() const {
+    return uniform_alignment;
+}
+
+bool StreamBuffer::IsPersistent() const {
+    return persistent;
+}
+
+void StreamBuffer::BeginFrame() {
+    retired_buffers.clear();
+
+    frame_idx = (frame_idx + 1) % FRAMES_IN_FLIGHT;
+    frame_offset = 0;
+
+    GLsync &fence = frame_fences[frame_idx];
+    if (!fence) {
+        return;
+    }
+
+    if (persistent) {
+        GLenum status = glClientWaitSync(fence, 0, 0);
+        while (status == GL_TIMEOUT_EXPIRED) {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+        }
+        if (status == GL_WAIT_FAILED) {
+            std::cerr << "ERROR::STREAM_BUFFER::FENCE_WAIT_FAILED" << std::endl;
+        }
+    } else if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+        // Кадр еще читается GPU - вместо ожидания отдаем драйверу старое хранилище
+        glBindBuffer(GL_COPY_WRITE_BUFFER, stream_buffer.Get());
+        glBufferData(GL_COPY_WRITE_BUFFER, frame_size * FRAMES_IN_FLIGHT, nullptr, GL_STREAM_DRAW);
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void StreamBuffer::EndFrame() {
+    GLsync &fence = frame_fences[frame_idx];
+    if (fence) {
+        glDeleteSync(fence);
+    }
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+bool StreamBuffer::HasSpace(GLsizeiptr size, GLsizeiptr alignment) const {
+    return AlignOffset(frame_offset, alignment) + size <= frame_size;
+}
+
+GLintptr StreamBuffer::Write(const void *data, GLsizeiptr size, GLsizeiptr alignment) {
+    if (!HasSpace(size, alignment)) {
+        GLsizeiptr new_frame_size = frame_size * 2;
+        while (new_frame_size < size) {
+            new_frame_size *= 2;
+        }
+        AllocateStorage(new_frame_size);
+    }
+
+    GLintptr region_offset = AlignOffset(frame_offset, alignment);
+    GLintptr offset = frame_idx * frame_size + region_offset;
+    frame_offset = region_offset + size;
+
+    if (persistent) {
+        std::memcpy(mapped_data + offset, data, size);
+    } else {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, stream_buffer.Get());
+        void *range = glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, size,
+                                       GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (range) {
+            std::memcpy(range, data, size);
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        } else {
+            std::cerr << "ERROR::STREAM_BUFFER::MAP_FAILED" << std::endl;
+        }
+    }
+    return offset;
+}
+
+void StreamBuffer::AllocateStorage(GLsizeiptr new_frame_size) {
+    ReleaseStorage();
+
+    stream_buffer = GLBuffer::Create();
+    frame_size = AlignOffset(new_frame_size, uniform_alignment);
+    frame_offset = 0;
+
+    GLsizeiptr buffer_size = frame_size * FRAMES_IN_FLIGHT;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, stream_buffer.Get());
+    stream_buffer.SetSize(buffer_size);
+    if (persistent) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_COPY_WRITE_BUFFER, buffer_size, nullptr, flags);
+        mapped_data = static_cast<GLubyte*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, buffer_size, flags));
+    } else {
+        glBufferData(GL_COPY_WRITE_BUFFER, buffer_size, nullptr, GL_STREAM_DRAW);
+    }
+}
+
+void StreamBuffer::ReleaseStorage() {
+    if (!stream_buffer) {
+        return;
+    }
+    if (mapped_data) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, stream_buffer.Get());
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        mapped_data = nullptr;
+    }
+    // Буфер может использоваться уже отправленными командами текущего кадра
+    retired_buffers.push_back(std::move(stream_buffer));
+}
+
+GLintptr StreamBuffer::AlignOffset(GLintptr offset, GLsizeiptr alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
@@ -4,11 +4,139 @@ TextureParametrs::TextureParametrs(GLfloat flare, GLfloat diff_coef, GLfloat hei
     : flare(flare), diff_coef(diff_coef), height_coef(height_coef) {}
 
 
+std::optional<GLuint> TextureUnits::GetTextureUnit(std::string_view type_texture, GLuint layer) {
+    std::optional<GLuint> unit;
+    if (type_texture == Texture2D::DIFFUSE_MAP) {
+        unit = DIFFUSE_MAP;
+    } else if (type_texture == Texture2D::SPECULAR_MAP) {
+        unit = SPECULAR_MAP;
+    } else if (type_texture == Texture2D::NORMAL_MAP) {
+        unit = NORMAL_MAP;
+    } else if (type_texture == Texture2D::DEPTH_MAP) {
+        unit = DEPTH_MAP;
+    } else if (type_texture == Texture2D::SHADOW_MAP) {
+        unit = SHADOW_MAP;
+    } else if (type_texture == TextureCube::SHADOW_CUBE_MAP) {
+        unit = SHADOW_CUBE_MAP;
+    }
+
+    if (!unit || *unit + layer * LAYER_STRIDE >= GLState::MAX_TEXTURE_UNITS) {
+        return std::nullopt;
+    }
+    return *unit + layer * LAYER_STRIDE;
+}
+
+std::optional<GLuint> TextureUnits::GetSamplerUnit(std::string_view name_uniform_var) {
+    size_t end_type = name_uniform_var.find_first_of("[.");
+    std::string_view type_texture = name_uniform_var.substr(0, end_type);
+
+    GLuint layer = 0;
+    if (end_type != std::string_view::npos && name_uniform_var[end_type] == '[') {
+        for (size_t idx = end_type + 1; idx < name_uniform_var.size() && name_uniform_var[idx] != ']'; ++idx) {
+            layer = layer * 10 + (name_uniform_var[idx] - '0');
+        }
+    }
+    return GetTextureUnit(type_texture, layer);
+}
+
+
+GLuint TextureSampler::GetSampler(SamplerType sampler_type) {
+    static std::array<GLSampler, static_cast<size_t>(SamplerType::COUNT)> samplers;
+
+    GLSampler &sampler = samplers[static_cast<size_t>(sampler_type)];
+    if (!sampler) {
+        sampler = CreateSampler(sampler_type);
+    }
+    return sampler.Get();
+}
+
+void TextureSampler::BindSamplers() {
+    for (GLuint unit = 0; unit < GLState::MAX_TEXTURE_UNITS; ++unit) {
+        auto sampler_type = GetSamplerType(unit);
+        glBindSampler(unit, sampler_type ? GetSampler(*sampler_type) : 0);
+    }
+}
+
+void TextureSampler::BindTextureUnits(const ShaderPipe& shader_program) {
+    shader_program.UseShaderPipe();
+    for (const auto &parameter : shader_program.GetParameters()) {
+        if (!parameter.sampler) {
+            continue;
+        }
+
+        auto unit = TextureUnits::GetSamplerUnit(parameter.name);
+        if (!unit) {
+            std::cerr << "ERROR::TEXTURE::UNKNOWN_SAMPLER " << parameter.name << std::endl;
+            continue;
+        }
+        shader_program.SetInt(parameter.location, *unit);
+    }
+}
+
+GLSampler TextureSampler::CreateSampler(SamplerType sampler_type) {
+    GLSampler sampler_handle = GLSampler::Create();
+    GLuint sampler = sampler_handle.Get();
+
+    switch (sampler_type) {
+    case SamplerType::SURFACE:
+        glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        break;
+    case SamplerType::SHADOW_MAP:
+        glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        break;
+    case SamplerType::SHADOW_CUBE_MAP:
+        glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glSamplerParameteri(sampler, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        break;
+    default:
+        std::cerr << "ERROR::TEXTURE::UNKNOWN_SAMPLER_TYPE" << std::endl;
+        break;
+    }
+    return sampler_handle;
+}
+
+std::optional<SamplerType> TextureSampler::GetSamplerType(GLuint unit) {
+    switch (unit % TextureUnits::LAYER_STRIDE) {
+    case TextureUnits::DIFFUSE_MAP:
+    case TextureUnits::SPECULAR_MAP:
+    case TextureUnits::NORMAL_MAP:
+    case TextureUnits::DEPTH_MAP:
+        return SamplerType::SURFACE;
+    case TextureUnits::SHADOW_MAP:
+        return SamplerType::SHADOW_MAP;
+    case TextureUnits::SHADOW_CUBE_MAP:
+        return SamplerType::SHADOW_CUBE_MAP;
+    default:
+        return std::nullopt;
+    }
+}
+
+
+TextureUniformNames::TextureUniformNames(const std::string& name)
+    : name(name),
+      texture(name + "." + std::string(Texture::TEXTURE)),
+      flare(name + "." + std::string(TextureParametrs::FLARE)),
+      diff_coef(name + "." + std::string(TextureParametrs::DIFF_COEF)),
+      height_coef(name + "." + std::string(TextureParametrs::HEIGHT_COEF)) {}
+
+
 std::optional<GLuint> Texture::GetTextureID() const {
-    return texture_id;
+    if (!texture_handle) {
+        return std::nullopt;
+    }
+    return texture_handle.Get();
 }
 
-std::optional <std::string> Texture::GetType() const {
+const std::optional<std::string>& Texture::GetType() const {
     return type;
 }
 
@@ -24,19 +152,10 @@ void Texture2D::LoadTexture(const std::vector<std::string>& textures_file_path,
         return;
     }
 
-    GLuint tmp_texture_id;
-    glGenTextures(1, &tmp_texture_id);
-
-    texture_id = tmp_texture_id;
+    texture_handle = GLTexture::Create();
     type = type_texture;
 
-    glBindTexture(GL_TEXTURE_2D, *texture_id); 
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    GLState::BindTexture(0, GL_TEXTURE_2D, texture_handle.Get());
 
     GLint width, height, nr_channels;
     GLboolean *texture = stbi_load(textures_file_path[0].c_str(), &width, &height, &nr_channels, 0);
@@ -49,6 +168,7 @@ void Texture2D::LoadTexture(const std::vector<std::string>& textures_file_path,
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, texture);
             glGenerateMipmap(GL_TEXTURE_2D);
         }
+        texture_handle.SetSize(static_cast<GLsizeiptr>(width) * height * (alpha ? 4 : 3) * 4 / 3);
     } else {
         std::cerr << "ERROR::TEXTURE::TEXTURE_LOADING_FAILED" << std::endl;
     }
@@ -57,29 +177,21 @@ void Texture2D::LoadTexture(const std::vector<std::string>& textures_file_path,
 }
 
 void Texture2D::GenShadowTexture(GLuint width, GLuint height) {
-    GLuint tmp_texture_id;
-    glGenTextures(1, &tmp_texture_id);
-
-    texture_id = tmp_texture_id;
+    texture_handle = GLTexture::Create();
     type = SHADOW_MAP;
 
-    glBindTexture(GL_TEXTURE_2D, *texture_id);
+    GLState::BindTexture(0, GL_TEXTURE_2D, texture_handle.Get());
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    texture_handle.SetSize(static_cast<GLsizeiptr>(width) * height * sizeof(GLfloat));
 }
 
-void Texture2D::UseTexture(const ShaderPipe& shader_program, const std::string name, GLuint idx) const  {
-    glActiveTexture(GL_TEXTURE0 + idx);
-    glBindTexture(GL_TEXTURE_2D, *texture_id);
+void Texture2D::UseTexture(const ShaderPipe& shader_program, const TextureUniformNames& names, GLuint unit) const  {
+    GLState::BindTexture(unit, GL_TEXTURE_2D, texture_handle.Get());
     if (texture_params) {
-        shader_program.SetFloat(name + "." + std::string(TextureParametrs::FLARE), texture_params->flare);
-        shader_program.SetFloat(name + "." + std::string(TextureParametrs::DIFF_COEF), texture_params->diff_coef);
-        shader_program.SetFloat(name + "." + std::string(TextureParametrs::HEIGHT_COEF), texture_params->height_coef);
+        shader_program.SetFloat(shader_program.GetLocation(names.flare), texture_params->flare);
+        shader_program.SetFloat(shader_program.GetLocation(names.diff_coef), texture_params->diff_coef);
+        shader_program.SetFloat(shader_program.GetLocation(names.height_coef), texture_params->height_coef);
     }
 }
 
@@ -88,7 +200,7 @@ void CreateTexture2DUnion(const std::vector<Texture2D> &texture_array,
                           const std::vector <ShaderPipe>& shader_programs, 
                           const std::vector <std::string> names) {
     for (size_t idx = 0; idx < texture_array.size(); ++idx) {
-        texture_array[idx].UseTexture(shader_programs[idx], names[idx], idx);
+        texture_array[idx].UseTexture(shader_programs[idx], TextureUniformNames(names[idx]), idx);
     }
 }
 
@@ -98,7 +210,7 @@ void BindShadowTexture(const Texture2D& shadow_texture, GLuint FBO_id) {
     }
 
     glBindFramebuffer(GL_FRAMEBUFFER, FBO_id);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, *shadow_texture.texture_id, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, shadow_texture.texture_handle.Get(), 0);
     glDrawBuffer(GL_NONE);
     glReadBuffer(GL_NONE);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -106,13 +218,10 @@ void BindShadowTexture(const Texture2D& shadow_texture, GLuint FBO_id) {
 
 
 void TextureCube::LoadTexture(const std::vector<std::string>& textures_file_path, const std::string& type_texture, bool alpha) {
-    GLuint tmp_textue_id;
-    glGenTextures(1, &tmp_textue_id);
-
-    texture_id = tmp_textue_id;
+    texture_handle = GLTexture::Create();
     type = type_texture;
 
-    glBindTexture(GL_TEXTURE_CUBE_MAP, *texture_id);
+    GLState::BindTexture(0, GL_TEXTURE_CUBE_MAP, texture_handle.Get());
 
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -128,6 +237,7 @@ void TextureCube::LoadTexture(const std::vector<std::string>& textures_file_path
         if (texture) {
             glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + idx, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, texture);
             glGenerateMipmap(GL_TEXTURE_2D);
+            texture_handle.SetSize(static_cast<GLsizeiptr>(width) * height * 3 * (idx + 1));
         } else {
             std::cerr << "ERROR::TEXTURE::TEXTURE_LOADING_FAILED" << std::endl;
         }
@@ -137,37 +247,24 @@ void TextureCube::LoadTexture(const std::vector<std::string>& textures_file_path
 }
 
 void TextureCube::UseTextureForShadowRendering() const {
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, *texture_id);
+    GLState::BindTexture(0, GL_TEXTURE_CUBE_MAP, texture_handle.Get());
 }
 
-void TextureCube::UseTexture(const ShaderPipe& shader_program, const std::string name, GLuint idx) const {
-    glActiveTexture(GL_TEXTURE0 + idx);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, *texture_id);
-    std::stringstream name_texture;
-    name_texture << name;
-    shader_program.SetInt(name_texture.str(), idx);
+void TextureCube::UseTexture(const ShaderPipe&, const TextureUniformNames&, GLuint unit) const {
+    GLState::BindTexture(unit, GL_TEXTURE_CUBE_MAP, texture_handle.Get());
 }
 
 void TextureCube::GenShadowTexture(GLuint width, GLuint height) {
-    GLuint tmp_texture_id;
-    glGenTextures(1, &tmp_texture_id);
-
-    texture_id = tmp_texture_id;
+    texture_handle = GLTexture::Create();
     type = SHADOW_CUBE_MAP;
 
-    glBindTexture(GL_TEXTURE_CUBE_MAP, *texture_id);
+    GLState::BindTexture(0, GL_TEXTURE_CUBE_MAP, texture_handle.Get());
 
     for (size_t idx = 0; idx < 6; ++idx) {
         glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + idx, 0, GL_DEPTH_COMPONENT, width, 
                      height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
     }
-
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    texture_handle.SetSize(static_cast<GLsizeiptr>(width) * height * sizeof(GLfloat) * 6);
 }
 
 void BindShadowCubeTexture(const TextureCube& shadow_texture, GLuint FBO_id) {
@@ -176,8 +273,18 @@ void BindShadowCubeTexture(const TextureCube& shadow_texture, GLuint FBO_id) {
     }
 
     glBindFramebuffer(GL_FRAMEBUFFER, FBO_id);
-    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, *shadow_texture.texture_id, 0);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, shadow_texture.texture_handle.Get(), 0);
     glDrawBuffer(GL_NONE);
     glReadBuffer(GL_NONE);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void BindShadowCubeFace(const TextureCube& shadow_texture, GLuint FBO_id, GLuint face) {
+    if (shadow_texture.type != TextureCube::SHADOW_CUBE_MAP) {
+        std::cerr << "ERROR::TEXTURE::TEXTURE_IS_NOT_SHADOW" << std::endl;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO_id);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP_POSITIVE_X + face,
+                           shadow_texture.texture_handle.Get(), 0);
 }
\ No newline at end of file
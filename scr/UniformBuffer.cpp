@@ -0,0 +1,42 @@
+#include "../libs/UniformBuffer.h"
+
+
+void UniformBuffer::CreateUniformBuffer(GLsizeiptr size, GLuint binding) {
+    buffer_data.assign(size, 0);
+    binding_point = binding;
+}
+
+GLuint UniformBuffer::GetBinding() const {
+    return binding_point;
+}
+
+void UniformBuffer::UpdateUniformBuffer(GLintptr offset, GLsizeiptr size, const void *data) {
+    if (offset < 0 || offset + size > static_cast<GLsizeiptr>(buffer_data.size())) {
+        std::cerr << "ERROR::UNIFORM_BUFFER::OUT_OF_RANGE" << std::endl;
+        return;
+    }
+
+    std::memcpy(&buffer_data[offset], data, size);
+}
+
+void UniformBuffer::CommitUniformBuffer(StreamBuffer &stream_buffer) const {
+    if (buffer_data.empty()) {
+        std::cerr << "ERROR::UNIFORM_BUFFER::NOT_CREATED" << std::endl;
+        return;
+    }
+
+    GLsizeiptr size = static_cast<GLsizeiptr>(buffer_data.size());
+    GLintptr offset = stream_buffer.Write(std::data(buffer_data), size, stream_buffer.GetUniformAlignment());
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding_point, *stream_buffer.GetStreamBufferID(), offset, size);
+}
+
+std::optional<GLuint> UniformBuffer::GetBindingPoint(const std::string &name_block) {
+    if (name_block == CAMERA_PARAM) {
+        return CAMERA_PARAM_BINDING;
+    } else if (name_block == LIGHT_DIRECTED_PARAM) {
+        return LIGHT_DIRECTED_PARAM_BINDING;
+    } else if (name_block == LIGHT_POINT_PARAM) {
+        return LIGHT_POINT_PARAM_BINDING;
+    }
+    return std::nullopt;
+}
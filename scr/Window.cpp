@@ -48,18 +48,21 @@ void Window::Initialize(const std::string& title) {
 }
 
 
-void Window::Rendering(Scene &scene, std::vector<ShaderPipe> shaders_shadow, std::vector<ShaderPipe> shaders_scene) {
+void Window::Rendering(Scene &scene, std::vector<ShaderPipe> shaders_shadow, std::vector<ShaderPipe> shaders_shadow_cube,
+                       std::vector<ShaderPipe> shaders_scene) {
 	glEnable(GL_DEPTH_TEST);
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	scene.SetCamera(&camera);
+	GLState::Invalidate();
 
 	while (!glfwWindowShouldClose(window)) {
 		GLfloat current_frame = glfwGetTime();
 		delta_time = current_frame - last_frame;
 		last_frame = current_frame;
 		KeyboardInput();
+		ReportFrameStats(current_frame);
 
 		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -69,16 +72,17 @@ void Window::Rendering(Scene &scene, std::vector<ShaderPipe> shaders_shadow, std
 		glBindFramebuffer(GL_FRAMEBUFFER, scene.GetShadowFBO());
 		glClear(GL_DEPTH_BUFFER_BIT);
 
+		scene.BeginFrame();
+		BeginVertexQuery();
+		size_t cnt_allocations = AllocationCounter::GetCount();
 		scene.Rendering(SHADOW_MAP_WIDTH, SHADOW_MAP_HEIGHT, shaders_shadow, delta_time, Scene::SwitchRender::SHADOW_MAP);
+		render_allocations += AllocationCounter::GetCount() - cnt_allocations;
 
-		//glViewport(0, 0, SHADOW_CUBE_MAP_WIDTH, SHADOW_CUBE_MAP_HEIGHT);
-		//glBindFramebuffer(GL_FRAMEBUFFER, shadow_cube_FBO);
-		//glClear(GL_DEPTH_BUFFER_BIT);
-
-		//scene.Rendering(SHADOW_MAP_WIDTH, SHADOW_MAP_HEIGHT, shaders_shadow, Scene::SwitchRender::SHADOW_MAP);
-
-		//Render(camera, SHADOW_CUBE_MAP_WIDTH, SHADOW_CUBE_MAP_HEIGHT, meshs_scene, shadow_map, shadow_cube_maps, 
-		//	shaders_shadow_cube, lights_point, light_directed, transforms, delta_time, SwitchRender::SHADOW_CUBE);
+		// Грани кубической карты сцена привязывает и очищает сама
+		glViewport(0, 0, SHADOW_CUBE_MAP_WIDTH, SHADOW_CUBE_MAP_HEIGHT);
+		cnt_allocations = AllocationCounter::GetCount();
+		scene.Rendering(SHADOW_CUBE_MAP_WIDTH, SHADOW_CUBE_MAP_HEIGHT, shaders_shadow_cube, delta_time, Scene::SwitchRender::SHADOW_CUBE);
+		render_allocations += AllocationCounter::GetCount() - cnt_allocations;
 
 
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -87,14 +91,108 @@ void Window::Rendering(Scene &scene, std::vector<ShaderPipe> shaders_shadow, std
 		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT);
 
+		cnt_allocations = AllocationCounter::GetCount();
 		scene.Rendering(SCR_WIDTH, SCR_HEIGHT, shaders_scene, delta_time, Scene::SwitchRender::SCENE);
+		render_allocations += AllocationCounter::GetCount() - cnt_allocations;
+		EndVertexQuery();
+		scene.EndFrame();
 
 		glfwSwapBuffers(window);
 		glfwPollEvents();
 	}
+	DeleteVertexQueries();
+	GLResourceRegistry::PrintStats();
+	GLResourceRegistry::ReleaseContext();
 	glfwTerminate();
 }
 
+void Window::ReportFrameStats(GLfloat current_frame) {
+	const auto &upload_stats = ShaderPipe::GetUploadStats();
+	const auto &state_stats = GLState::GetStats();
+	const auto &draw_stats = GeometryArena::GetDrawStats();
+	if (cnt_frames > 0 && current_frame - last_stats_report >= STATS_REPORT_INTERVAL) {
+		std::cout << "FRAME_STATS::UNIFORM_UPLOADS ISSUED " << upload_stats.uploaded / cnt_frames
+				  << ", SKIPPED " << upload_stats.skipped / cnt_frames
+				  << ", MISSING " << upload_stats.missing / cnt_frames << " (per frame)" << std::endl;
+		std::cout << "FRAME_STATS::STATE_CHANGES ISSUED " << state_stats.issued / cnt_frames
+				  << ", ELIDED " << state_stats.elided / cnt_frames << " (per frame)" << std::endl;
+		if constexpr (AllocationCounter::ENABLED) {
+			std::cout << "FRAME_STATS::RENDER_ALLOCATIONS " << render_allocations / cnt_frames << " (per frame)" << std::endl;
+			// Первый интервал включает прогрев: рост векторов очередей и буферов команд до рабочего размера
+			if (render_allocations > 0 && last_stats_report > 0.0f) {
+				std::cerr << "ERROR::WINDOW::ALLOCATIONS_IN_RENDER_LOOP " << render_allocations << std::endl;
+			}
+		}
+		if (cnt_vertex_query_frames > 0) {
+			std::cout << "FRAME_STATS::VERTEX_SHADER_INVOCATIONS " << vertex_invocations / cnt_vertex_query_frames
+					  << ", WITHOUT INDEX REUSE " << draw_stats.indexes / cnt_frames << " (per frame)" << std::endl;
+			vertex_invocations = 0;
+			cnt_vertex_query_frames = 0;
+		}
+		last_stats_report = current_frame;
+		cnt_frames = 0;
+		render_allocations = 0;
+		ShaderPipe::ResetUploadStats();
+		GLState::ResetStats();
+		GeometryArena::ResetDrawStats();
+	}
+	++cnt_frames;
+}
+
+bool Window::IsVertexQuerySupported() {
+#ifdef GL_ARB_pipeline_statistics_query
+	return GLAD_GL_VERSION_4_6 || GLAD_GL_ARB_pipeline_statistics_query;
+#else
+	return false;
+#endif
+}
+
+void Window::BeginVertexQuery() {
+#ifdef GL_ARB_pipeline_statistics_query
+	if (!IsVertexQuerySupported()) {
+		return;
+	}
+	auto &query = vertex_queries[vertex_query_idx];
+	if (!query) {
+		query = GLQuery::Create();
+	}
+
+	if (vertex_queries_pending[vertex_query_idx]) {
+		GLuint available = GL_FALSE;
+		glGetQueryObjectuiv(query.Get(), GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) {
+			return;
+		}
+		GLuint64 invocations = 0;
+		glGetQueryObjectui64v(query.Get(), GL_QUERY_RESULT, &invocations);
+		vertex_invocations += invocations;
+		++cnt_vertex_query_frames;
+		vertex_queries_pending[vertex_query_idx] = false;
+	}
+	glBeginQuery(GL_VERTEX_SHADER_INVOCATIONS_ARB, query.Get());
+	vertex_query_active = true;
+#endif
+}
+
+void Window::EndVertexQuery() {
+#ifdef GL_ARB_pipeline_statistics_query
+	if (!vertex_query_active) {
+		return;
+	}
+	glEndQuery(GL_VERTEX_SHADER_INVOCATIONS_ARB);
+	vertex_query_active = false;
+	vertex_queries_pending[vertex_query_idx] = true;
+	vertex_query_idx = (vertex_query_idx + 1) % vertex_queries.size();
+#endif
+}
+
+void Window::DeleteVertexQueries() {
+	for (auto &query : vertex_queries) {
+		query.Reset();
+	}
+	vertex_queries_pending.fill(false);
+}
+
 void Window::KeyboardInput() {
 	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
 		glfwSetWindowShouldClose(window, true);